@@ -0,0 +1,135 @@
+// Homework 2
+// Implement batched Dijkstra algorithm over small graphs.
+
+#include "batched_dijkstra.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+const double INFINITE_DISTANCE = numeric_limits<double>::infinity();
+
+// =================
+//  BatchedDijkstra
+// =================
+
+// Construct the batch.
+BatchedDijkstra::BatchedDijkstra(int capacity)
+  : capacity_(capacity),
+    distances_(capacity * BATCH_LANES, INFINITE_DISTANCE),
+    keys_(capacity * BATCH_LANES, INFINITE_DISTANCE),
+    weights_(capacity * capacity * BATCH_LANES, INFINITE_DISTANCE) {}
+
+// Add edge to the graph of the given lane.
+void BatchedDijkstra::add_edge(int lane, int vertex1, int vertex2,
+			       double distance) {
+  int forward = index(vertex1, vertex2, lane);
+  int backward = index(vertex2, vertex1, lane);
+
+  assert(0 <= lane && lane < BATCH_LANES);
+  assert(distance >= 0.0);
+
+  // Don't add an edge from a vertex to itself.
+  if(vertex1 == vertex2)
+    return;
+  edges_.push_back(forward);
+  edges_.push_back(backward);
+  weights_[forward] = weights_[backward] = min(weights_[forward], distance);
+}
+
+// Remove all edges of all lanes.  Indices of parallel edges may repeat.
+void BatchedDijkstra::clear() {
+  for(int edge: edges_)
+    weights_[edge] = INFINITE_DISTANCE;
+  edges_.clear();
+}
+
+// Copy shortest-path distances of the given lane.
+void BatchedDijkstra::distances(int lane, vector<double>& distances) const {
+  double distance;
+
+  distances.resize(capacity_);
+  for(int vertex = 0; vertex < capacity_; vertex++) {
+    distance = distances_[index(vertex, lane)];
+    distances[vertex] = distance == INFINITE_DISTANCE ? NO_PATH : distance;
+  }
+}
+
+// Add all edges of the given graph to the graph of the given lane.
+void BatchedDijkstra::load(int lane, const AdjacencyGraph& graph) {
+  assert(graph.capacity() <= capacity_);
+  for(int vertex = 0; vertex < graph.capacity(); vertex++)
+    for(auto& neighbor: graph.neighbors(vertex))
+      if(vertex < neighbor.vertex)
+	add_edge(lane, vertex, neighbor.vertex, neighbor.distance);
+}
+
+// Compute shortest paths from the given source in all lanes.  Each step
+// settles one vertex per lane.  A lane that has run out of reachable
+// vertices selects an infinite distance, whose relaxation changes
+// nothing, so all lanes run the same steps.  Vertex numbers are kept as
+// doubles so that selection masks and values have the same width.
+void BatchedDijkstra::shortest_paths(int source) {
+  const LaneVector infinite = LaneVector{} + INFINITE_DISTANCE;
+  LaneVector closest_distance[LANE_VECTORS], closest[LANE_VECTORS];
+  LaneVector vertex_number, weight = LaneVector{};
+  int row[BATCH_LANES], vertex;
+  bool reachable;
+
+  fill(distances_.begin(), distances_.end(), INFINITE_DISTANCE);
+  fill(distances_.begin() + index(source, 0),
+       distances_.begin() + index(source + 1, 0), 0.0);
+  keys_ = distances_;
+  for(int step = 0; step < capacity_; step++) {
+
+    // Select the closest unsettled vertex of each lane.
+    for(int i = 0; i < LANE_VECTORS; i++) {
+      LaneVector nearest_distance = infinite;
+      LaneVector nearest = LaneVector{} + source;
+      vertex_number = LaneVector{};
+      for(vertex = 0; vertex < capacity_; vertex++) {
+	LaneVector key = lanes(keys_, index(vertex, i * LANE_VECTOR_WIDTH));
+	auto closer = key < nearest_distance;
+	nearest_distance = closer ? key : nearest_distance;
+	nearest = closer ? vertex_number : nearest;
+	vertex_number += 1.0;
+      }
+      closest_distance[i] = nearest_distance;
+      closest[i] = nearest;
+    }
+    reachable = false;
+    for(int lane = 0; lane < BATCH_LANES; lane++) {
+      int i = lane / LANE_VECTOR_WIDTH, j = lane % LANE_VECTOR_WIDTH;
+      vertex = closest[i][j];
+      reachable |= closest_distance[i][j] != INFINITE_DISTANCE;
+      row[lane] = index(vertex, 0, lane);
+      keys_[index(vertex, lane)] = INFINITE_DISTANCE;
+    }
+    if(!reachable)
+      break;
+
+    // Relax the edges of the closest vertices.  A settled vertex is
+    // never closer than the closest vertex, so its key stays infinite.
+    for(int i = 0; i < LANE_VECTORS; i++) {
+      int first = i * LANE_VECTOR_WIDTH;
+      LaneVector nearest_distance = closest_distance[i];
+      for(vertex = 0; vertex < capacity_; vertex++) {
+
+	// Gather the weights of the closest vertices.  Unrolling keeps the
+	// vector in a register.
+#pragma GCC unroll 8
+	for(int j = 0; j < LANE_VECTOR_WIDTH; j++)
+	  weight[j] = weights_[row[first + j] + vertex * BATCH_LANES];
+	LaneVector distance = nearest_distance + weight;
+	LaneVector& current = lanes(distances_, index(vertex, first));
+	LaneVector& key = lanes(keys_, index(vertex, first));
+	auto shorter = distance < current;
+	key = shorter ? distance : key;
+	current = shorter ? distance : current;
+      }
+    }
+  }
+}
@@ -0,0 +1,87 @@
+// Header file for batched Dijkstra algorithm over small graphs.
+
+#ifndef BATCHED_DIJKSTRA_H_
+#define BATCHED_DIJKSTRA_H_
+
+#include "dijkstra.h"
+
+#include <vector>
+
+const int BATCH_LANES = 8;  // Independent graphs per batch.
+using namespace std;
+
+// Doubles per SIMD register of the target.
+#if defined(__AVX512F__)
+const int LANE_VECTOR_WIDTH = 8;
+#elif defined(__AVX__)
+const int LANE_VECTOR_WIDTH = 4;
+#else
+const int LANE_VECTOR_WIDTH = 2;
+#endif
+// SIMD registers per set of lanes.
+const int LANE_VECTORS = BATCH_LANES / LANE_VECTOR_WIDTH;
+
+// Values of consecutive lanes as a GCC vector that fills a SIMD register
+// of the target.  The alignment is lowered to that of double, so lane
+// vectors can live in vector<double> storage.
+typedef double LaneVector
+  __attribute__((vector_size(LANE_VECTOR_WIDTH * sizeof(double)),
+		 aligned(8)));
+
+// A class to compute single-source shortest paths in BATCH_LANES small
+// independent graphs at once.  Each graph occupies a lane.  Weights and
+// distances are stored as structures of arrays with the lane as the
+// innermost index, so a dense O(V^2) Dijkstra runs all lanes in
+// lockstep: every step selects the closest unsettled vertex of each lane
+// and relaxes its matrix row, with branch-free operations on
+// LaneVector.  For graphs of tens of vertices this avoids the heap and
+// the data-dependent control flow of AdjacencyDijkstra.
+// Missing edges have infinite weights, and edge distances must not be
+// negative.
+class BatchedDijkstra {
+ public:
+  // Construct the batch for vertices 0 to capacity-1.
+  BatchedDijkstra(int capacity);
+  // Add edge to the graph of the given lane.  Keep the shorter distance
+  // of parallel edges.
+  void add_edge(int lane, int vertex1, int vertex2, double distance);
+  // Return the vertex capacity of the graphs.
+  int capacity() const { return capacity_; }
+  // Remove all edges of all lanes.  The cost is proportional to the
+  // number of edges added since the last clear.
+  void clear();
+  // Copy shortest-path distances of the given lane into distances, which
+  // is indexed by vertex.  Unreachable vertices get NO_PATH.
+  void distances(int lane, vector<double>& distances) const;
+  // Add all edges of the given graph to the graph of the given lane.
+  void load(int lane, const AdjacencyGraph& graph);
+  // Compute shortest paths from the given source in all lanes.
+  void shortest_paths(int source);
+
+ private:
+  // Return index of the given vertex and lane.
+  int index(int vertex, int lane) const {
+    return vertex * BATCH_LANES + lane;
+  }
+  // Return lane vector of the given values starting at the given index.
+  LaneVector& lanes(vector<double>& values, int index) {
+    return *reinterpret_cast<LaneVector*>(&values[index]);
+  }
+  // Return index of the given edge and lane.
+  int index(int vertex1, int vertex2, int lane) const {
+    return (vertex1 * capacity_ + vertex2) * BATCH_LANES + lane;
+  }
+  // Number of vertices.
+  int capacity_;
+  // Shortest-path distances by vertex and lane.
+  vector<double> distances_;
+  // Indices of weights set since the last clear.
+  vector<int> edges_;
+  // Distances of unsettled vertices by vertex and lane.  Settled and
+  // unreached vertices have infinite keys.
+  vector<double> keys_;
+  // Edge weights by vertex pair and lane.
+  vector<double> weights_;
+};
+
+#endif // BATCHED_DIJKSTRA_H_
@@ -0,0 +1,76 @@
+// Unit tests for batched Dijkstra algorithm using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "batched_dijkstra.h"
+#include "philox.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace std;
+
+TEST(batched_dijkstra_test_suite, test_graph3) {
+  BatchedDijkstra batch = BatchedDijkstra(8);
+  vector<double> results;
+  vector<double> expect = { NO_PATH, 0.0, 7.0, 9.0, 20.0, 20.0, 11.0,
+			    NO_PATH };
+
+  // Lane 2 has the graph, and the other lanes are empty.
+  batch.add_edge(2, 1, 2, 7);
+  batch.add_edge(2, 1, 3, 9);
+  batch.add_edge(2, 1, 6, 14);
+  batch.add_edge(2, 2, 3, 10);
+  batch.add_edge(2, 2, 4, 15);
+  batch.add_edge(2, 3, 4, 11);
+  batch.add_edge(2, 3, 6, 2);
+  batch.add_edge(2, 4, 5, 6);
+  batch.add_edge(2, 5, 6, 9);
+  batch.add_edge(2, 5, 6, 12);
+  batch.add_edge(2, 7, 7, 1);
+  batch.shortest_paths(1);
+  batch.distances(2, results);
+  EXPECT_TRUE(expect == results) << "Shortest paths from 1 are wrong.";
+  batch.distances(0, results);
+  expect = { NO_PATH, 0.0, NO_PATH, NO_PATH, NO_PATH, NO_PATH, NO_PATH,
+	     NO_PATH };
+  EXPECT_TRUE(expect == results) << "Empty lane should reach only 1.";
+
+  // Clear and rebuild.
+  batch.clear();
+  batch.add_edge(2, 1, 7, 3);
+  batch.shortest_paths(7);
+  batch.distances(2, results);
+  expect = { NO_PATH, 3.0, NO_PATH, NO_PATH, NO_PATH, NO_PATH, NO_PATH,
+	     0.0 };
+  EXPECT_TRUE(expect == results) << "Shortest paths after clear are wrong.";
+}
+
+TEST(batched_dijkstra_test_suite, test_random_graphs) {
+  const int capacity = 40;
+  BatchedDijkstra batch = BatchedDijkstra(capacity);
+  AdjacencyDijkstra dsa = AdjacencyDijkstra(capacity);
+  vector<AdjacencyGraph> graphs(BATCH_LANES, AdjacencyGraph(capacity));
+  vector<double> results, expect;
+  Philox generator = Philox(17);
+
+  // Lanes of different densities should match Dijkstra lane by lane.
+  for(int round = 0; round < 5; round++) {
+    batch.clear();
+    for(int lane = 0; lane < BATCH_LANES; lane++) {
+      double density = 0.02 + 0.05 * lane;
+      graphs[lane].reset();
+      for(int vertex1 = 0; vertex1 < capacity; vertex1++)
+	for(int vertex2 = vertex1 + 1; vertex2 < capacity; vertex2++)
+	  if(generator() < density * Philox::max())
+	    graphs[lane].add_edge(vertex1, vertex2, 1 + generator() % 10);
+      batch.load(lane, graphs[lane]);
+    }
+    batch.shortest_paths(0);
+    for(int lane = 0; lane < BATCH_LANES; lane++) {
+      dsa.shortest_paths(graphs[lane], 0, expect);
+      batch.distances(lane, results);
+      EXPECT_TRUE(expect == results)
+	<< "Shortest paths are wrong in round " << round << " lane " << lane;
+    }
+  }
+}
@@ -0,0 +1,175 @@
+// Implement benchmark timing and reporting utilities.
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+using namespace std;
+
+const int REPORT_PRECISION = 9;  // Significant digits of reported values.
+
+// Parse report format from string.
+bool parse_report_format(const string& name, ReportFormat& format) {
+  if(name == "json")
+    format = ReportFormat::JSON;
+  else if(name == "csv")
+    format = ReportFormat::CSV;
+  else
+    return false;
+  return true;
+}
+
+// Write the given string as a quoted JSON string, with quotes,
+// backslashes and control characters escaped.
+static void write_json_string(ostream& out, const string& value) {
+  const char hex[] = "0123456789abcdef";
+
+  out << '"';
+  for(char ch: value) {
+    unsigned char code = ch;
+    if(ch == '"' || ch == '\\')
+      out << '\\' << ch;
+    else if(code < 0x20)
+      out << "\\u00" << hex[code >> 4] << hex[code & 0xf];
+    else
+      out << ch;
+  }
+  out << '"';
+}
+
+// Write the given string as a quoted CSV field, with quotes doubled, so
+// that commas, quotes and line breaks stay within the field.
+static void write_csv_string(ostream& out, const string& value) {
+  out << '"';
+  for(char ch: value) {
+    if(ch == '"')
+      out << '"';
+    out << ch;
+  }
+  out << '"';
+}
+
+// Return peak resident set size of this process in kilobytes.
+long peak_rss_kb() {
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage))
+    return 0;
+  return usage.ru_maxrss;
+}
+
+// =============
+//  TimingStats
+// =============
+
+// Return sample at the given fraction using nearest rank.
+double TimingStats::percentile(double fraction) const {
+  if(samples_.empty())
+    return 0.0;
+  vector<double> sorted = samples_;
+  int rank = fraction * sorted.size();
+  rank = std::min<int>(rank, sorted.size() - 1);
+  nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  return sorted[rank];
+}
+
+// Return total of all samples.
+double TimingStats::total() const {
+  double result = 0.0;
+  for(double sample: samples_)
+    result += sample;
+  return result;
+}
+
+// =================
+//  BenchmarkReport
+// =================
+
+// Add numeric parameter or result.
+void BenchmarkReport::add_parameter(const string& key, double value) {
+  ostringstream ss;
+  ss << setprecision(REPORT_PRECISION) << value;
+  parameters_.push_back({ key, ss.str(), false });
+}
+
+// Add string parameter or result.
+void BenchmarkReport::add_parameter(const string& key, const string& value) {
+  parameters_.push_back({ key, value, true });
+}
+
+// Write the report.
+void BenchmarkReport::write(ostream& out, ReportFormat format) const {
+  switch(format) {
+  case ReportFormat::JSON:
+    write_json(out);
+    break;
+  case ReportFormat::CSV:
+    write_csv(out);
+    break;
+  }
+}
+
+// Write the report in CSV format.  The precision of the stream is
+// restored at the end.
+void BenchmarkReport::write_csv(ostream& out) const {
+  streamsize precision = out.precision();
+
+  out << "benchmark";
+  for(auto& parameter: parameters_)
+    out << ',' << parameter.key;
+  out << ",phase,samples,min,median,p99\n";
+  out << setprecision(REPORT_PRECISION);
+  for(auto& phase: phases_) {
+    out << name_;
+    for(auto& parameter: parameters_) {
+      out << ',';
+      if(parameter.quoted)
+	write_csv_string(out, parameter.value);
+      else
+	out << parameter.value;
+    }
+    out << ',' << phase.first << ',' << phase.second.size()
+	<< ',' << phase.second.min() << ',' << phase.second.median()
+	<< ',' << phase.second.percentile(0.99) << '\n';
+  }
+  out.precision(precision);
+  out.flush();
+}
+
+// Write the report in JSON format.  The precision of the stream is
+// restored at the end.
+void BenchmarkReport::write_json(ostream& out) const {
+  streamsize precision = out.precision();
+
+  out << "{\"benchmark\": ";
+  write_json_string(out, name_);
+  for(auto& parameter: parameters_) {
+    out << ", ";
+    write_json_string(out, parameter.key);
+    out << ": ";
+    if(parameter.quoted)
+      write_json_string(out, parameter.value);
+    else
+      out << parameter.value;
+  }
+  out << ", \"phases\": [";
+  out << setprecision(REPORT_PRECISION);
+  for(int i = 0; i < int(phases_.size()); i++) {
+    const TimingStats& stats = phases_[i].second;
+    if(i)
+      out << ", ";
+    out << "{\"phase\": ";
+    write_json_string(out, phases_[i].first);
+    out << ", \"samples\": " << stats.size()
+	<< ", \"min\": " << stats.min()
+	<< ", \"median\": " << stats.median()
+	<< ", \"p99\": " << stats.percentile(0.99) << '}';
+  }
+  out << "]}" << endl;
+  out.precision(precision);
+}
@@ -0,0 +1,119 @@
+// Header file for benchmark timing and reporting utilities.
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <chrono>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Report formats.
+enum class ReportFormat { JSON, CSV };
+
+// Parse report format from string.  Return false for unknown format.
+bool parse_report_format(const string& name, ReportFormat& format);
+
+// Return peak resident set size of this process in kilobytes.
+long peak_rss_kb();
+
+// A stream buffer that discards all output.  Wrap it in an ostream to
+// measure formatting cost without any I/O.
+class NullBuffer : public streambuf {
+ protected:
+  // Discard a single character.
+  int overflow(int ch) { return ch; }
+  // Discard a sequence of characters.
+  streamsize xsputn(const char*, streamsize n) { return n; }
+};
+
+// A class to measure elapsed wall-clock time.
+class Stopwatch {
+ public:
+  // Construct and start the stopwatch.
+  Stopwatch() : start_(chrono::steady_clock::now()) {}
+  // Return elapsed seconds since start.
+  double elapsed() const {
+    chrono::duration<double> duration = chrono::steady_clock::now() - start_;
+    return duration.count();
+  }
+  // Restart the stopwatch.
+  void restart() { start_ = chrono::steady_clock::now(); }
+  // Return elapsed seconds since start and restart the stopwatch.
+  double lap() {
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    chrono::duration<double> duration = now - start_;
+    start_ = now;
+    return duration.count();
+  }
+
+ private:
+  chrono::steady_clock::time_point start_;
+};
+
+// A class to collect timing samples of a phase and compute order
+// statistics.
+class TimingStats {
+ public:
+  // Construct timing statistics.
+  TimingStats() : samples_({}) {}
+  // Add sample in seconds.
+  void add(double seconds) { samples_.push_back(seconds); }
+  // Return minimum sample.
+  double min() const { return percentile(0.0); }
+  // Return median sample.
+  double median() const { return percentile(0.5); }
+  // Return sample at the given fraction using nearest rank.
+  double percentile(double fraction) const;
+  // Return number of samples.
+  int size() const { return samples_.size(); }
+  // Return total of all samples.
+  double total() const;
+
+ private:
+  vector<double> samples_;
+};
+
+// A class to build a machine-readable benchmark report.  The report
+// holds parameters as key-value pairs and timing statistics of named
+// phases.  In CSV format, each phase is written as one row that also
+// repeats the parameters.
+class BenchmarkReport {
+ public:
+  // Construct a report for the named benchmark.
+  BenchmarkReport(const string& name) : name_(name) {}
+  // Add numeric parameter or result.
+  void add_parameter(const string& key, double value);
+  // Add string parameter or result.
+  void add_parameter(const string& key, const string& value);
+  // Add timing statistics of a phase.
+  void add_phase(const string& phase, const TimingStats& stats) {
+    phases_.push_back(make_pair(phase, stats));
+  }
+  // Write the report.
+  void write(ostream& out, ReportFormat format) const;
+
+ private:
+  // Write the report in CSV format.
+  void write_csv(ostream& out) const;
+  // Write the report in JSON format.
+  void write_json(ostream& out) const;
+  // Benchmark name.
+  string name_;
+  // Parameter with its value formatted for output.  String values are
+  // quoted in JSON and CSV.
+  struct Parameter {
+    string key, value;
+    bool quoted;
+  };
+  // Benchmark parameters and results.
+  vector<Parameter> parameters_;
+  // Phases and their timing statistics.
+  vector<pair<string, TimingStats> > phases_;
+};
+
+#endif // BENCHMARK_H_
@@ -0,0 +1,92 @@
+// Unit tests for benchmark timing and reporting utilities using
+// Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "benchmark.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+TEST(timing_stats_test_suite, test_order_statistics) {
+  TimingStats stats = TimingStats();
+  for(int i = 100; i >= 1; i--)
+    stats.add(i);
+  EXPECT_EQ(100, stats.size()) << "There should be 100 samples.";
+  EXPECT_EQ(1, stats.min()) << "Min. should be 1.";
+  EXPECT_EQ(51, stats.median()) << "Median should be 51.";
+  EXPECT_EQ(100, stats.percentile(0.99)) << "p99 should be 100.";
+  EXPECT_EQ(5050, stats.total()) << "Total should be 5050.";
+}
+
+TEST(timing_stats_test_suite, test_empty_stats) {
+  TimingStats stats = TimingStats();
+  EXPECT_EQ(0, stats.min()) << "Min. of no samples should be 0.";
+}
+
+TEST(benchmark_report_test_suite, test_json_report) {
+  BenchmarkReport report = BenchmarkReport("test");
+  TimingStats stats = TimingStats();
+  stats.add(2);
+  report.add_parameter("file", "graph.txt");
+  report.add_parameter("repetitions", 1);
+  report.add_phase("mst", stats);
+  ostringstream ss;
+  report.write(ss, ReportFormat::JSON);
+  EXPECT_EQ("{\"benchmark\": \"test\", \"file\": \"graph.txt\", "
+	    "\"repetitions\": 1, \"phases\": [{\"phase\": \"mst\", "
+	    "\"samples\": 1, \"min\": 2, \"median\": 2, \"p99\": 2}]}\n",
+	    ss.str()) << "Unexpected JSON report.";
+}
+
+TEST(benchmark_report_test_suite, test_json_escapes) {
+  BenchmarkReport report = BenchmarkReport("a\"b");
+  TimingStats stats = TimingStats();
+  stats.add(2);
+  report.add_parameter("file", "C:\\graph \"1\".txt\n");
+  report.add_phase("p\\q", stats);
+  ostringstream ss;
+  report.write(ss, ReportFormat::JSON);
+  EXPECT_EQ("{\"benchmark\": \"a\\\"b\", "
+	    "\"file\": \"C:\\\\graph \\\"1\\\".txt\\u000a\", "
+	    "\"phases\": [{\"phase\": \"p\\\\q\", "
+	    "\"samples\": 1, \"min\": 2, \"median\": 2, \"p99\": 2}]}\n",
+	    ss.str()) << "Strings should be escaped.";
+}
+
+TEST(benchmark_report_test_suite, test_csv_report) {
+  BenchmarkReport report = BenchmarkReport("test");
+  TimingStats stats = TimingStats();
+  stats.add(2);
+  report.add_parameter("repetitions", 1);
+  report.add_phase("parse", stats);
+  report.add_phase("mst", stats);
+  ostringstream ss;
+  report.write(ss, ReportFormat::CSV);
+  EXPECT_EQ("benchmark,repetitions,phase,samples,min,median,p99\n"
+	    "test,1,parse,1,2,2,2\n"
+	    "test,1,mst,1,2,2,2\n", ss.str()) << "Unexpected CSV report.";
+
+  // String values are quoted, and the precision of the stream is kept.
+  BenchmarkReport quoted = BenchmarkReport("test");
+  quoted.add_parameter("input", "a,\"b\".txt");
+  quoted.add_phase("mst", stats);
+  ostringstream quoted_ss;
+  quoted_ss.precision(3);
+  quoted.write(quoted_ss, ReportFormat::CSV);
+  EXPECT_EQ("benchmark,input,phase,samples,min,median,p99\n"
+	    "test,\"a,\"\"b\"\".txt\",mst,1,2,2,2\n", quoted_ss.str())
+    << "Strings should be quoted.";
+  EXPECT_EQ(3, quoted_ss.precision()) << "CSV should keep the precision.";
+  quoted.write(quoted_ss, ReportFormat::JSON);
+  EXPECT_EQ(3, quoted_ss.precision()) << "JSON should keep the precision.";
+}
+
+TEST(report_format_test_suite, test_parse_report_format) {
+  ReportFormat format;
+  EXPECT_TRUE(parse_report_format("csv", format)) << "csv should parse.";
+  EXPECT_TRUE(format == ReportFormat::CSV) << "Format should be CSV.";
+  EXPECT_FALSE(parse_report_format("xml", format)) << "xml should fail.";
+}
@@ -0,0 +1,85 @@
+// Implement concurrent union-find data structure.
+
+#include "concurrent_union_find.h"
+
+#include <atomic>
+
+using namespace std;
+
+// =====================
+//  ConcurrentUnionFind
+// =====================
+
+// Construct a union-find of the given universe and virtual vertices.
+ConcurrentUnionFind::ConcurrentUnionFind(Vertex universe,
+					 Vertex virtual_vertices)
+  : parents_(universe + virtual_vertices),
+    virtual_vertices_(virtual_vertices) {
+  clear();
+}
+
+// Reset all vertices to singletons.
+void ConcurrentUnionFind::clear() {
+  for(Vertex index = 0; index < Vertex(parents_.size()); index++)
+    parents_[index].store(index, memory_order_relaxed);
+}
+
+// Return whether two vertices are in the same set.  If the roots differ
+// but the first is still a root after the second find, the sets were
+// distinct at that instant.
+bool ConcurrentUnionFind::connected(Vertex vertex1, Vertex vertex2) {
+  Vertex root1 = to_index(vertex1), root2 = to_index(vertex2);
+
+  while(true) {
+    root1 = find_index(root1);
+    root2 = find_index(root2);
+    if(root1 == root2)
+      return true;
+    if(parents_[root1].load(memory_order_acquire) == root1)
+      return false;
+  }
+}
+
+// Return root index of the given index with path splitting.  A failed
+// compare-and-swap means another thread moved the parent closer to the
+// root already, so it is not retried.  The swap expects a copy of the
+// parent, since a failure overwrites it, and the walk goes on from the
+// values loaded.
+Vertex ConcurrentUnionFind::find_index(Vertex index) {
+  Vertex parent = parents_[index].load(memory_order_acquire);
+
+  while(parent != index) {
+    Vertex grandparent = parents_[parent].load(memory_order_acquire);
+    if(grandparent != parent) {
+      Vertex expect = parent;
+      parents_[index].compare_exchange_weak(expect, grandparent,
+					    memory_order_release,
+					    memory_order_relaxed);
+    }
+    index = parent;
+    parent = grandparent;
+  }
+  return index;
+}
+
+// Join a pair of vertices.  Only a root is ever linked, and only by a
+// compare-and-swap that expects it to still be a root, so a root linked
+// by another thread in the meantime makes this call retry.
+bool ConcurrentUnionFind::join(Vertex vertex1, Vertex vertex2) {
+  Vertex root1 = to_index(vertex1), root2 = to_index(vertex2);
+
+  while(true) {
+    root1 = find_index(root1);
+    root2 = find_index(root2);
+    if(root1 == root2)
+      return false;
+
+    // Link the root of lower priority under the other.
+    if(lower_priority(root2, root1))
+      swap(root1, root2);
+    Vertex expect = root1;
+    if(parents_[root1].compare_exchange_strong(expect, root2,
+					       memory_order_acq_rel))
+      return true;
+  }
+}
@@ -0,0 +1,95 @@
+// Header file for concurrent union-find data structure.
+
+#ifndef CONCURRENT_UNION_FIND_H_
+#define CONCURRENT_UNION_FIND_H_
+
+#include "union_find.h"
+
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// Lock-free union-find that threads may share, after Jayanti & Tarjan,
+// Concurrent disjoint set union, 2016, and Anderson & Woll, Wait-free
+// parallel algorithms for the union-find problem, STOC 1991.
+//
+// Each vertex holds an atomic parent.  find() walks to the root with
+// path splitting, and each splitting step is a single compare-and-swap
+// that may fail harmlessly when another thread changed the parent first,
+// so finds never wait.  join() links the root of lower priority under
+// the other with a compare-and-swap on the parent of the root, and
+// retries from fresh roots when another thread linked that root first.
+// Priorities are a fixed hash of the vertex, which plays the role of the
+// rank in expectation and keeps the trees shallow.
+//
+// The universe is fixed: vertices 0 to universe - 1, plus the virtual
+// vertices -1 to -virtual_vertices.  clear() must not run concurrently
+// with other operations.
+class ConcurrentUnionFind {
+ public:
+  // Construct a union-find of the given universe and number of virtual
+  // vertices.
+  explicit ConcurrentUnionFind(Vertex universe, Vertex virtual_vertices=0);
+  // Reset all vertices to singletons.  Not thread-safe.
+  void clear();
+  // Return whether two vertices are in the same set.  The answer is
+  // exact at some instant during the call.
+  bool connected(Vertex vertex1, Vertex vertex2);
+  // Return the root vertex of a given vertex.  The root may change as
+  // soon as other threads join.
+  Vertex find(Vertex vertex) {
+    return to_vertex(find_index(to_index(vertex)));
+  }
+  // Join a pair of vertices.  Return true if they were in different
+  // sets, i.e. if this call linked them.
+  bool join(Vertex vertex1, Vertex vertex2);
+  // Return whether join() links the root vertex1 under the root vertex2.
+  // Mainly for testing.
+  bool links_under(Vertex vertex1, Vertex vertex2) const {
+    return lower_priority(to_index(vertex1), to_index(vertex2));
+  }
+  // Prefetch the parent entry of the given vertex, and with parent set,
+  // that of its parent, which must be in cache by then to be cheap.
+  void prefetch(Vertex vertex, bool parent=false) const {
+    Vertex index = to_index(vertex);
+    if(parent)
+      index = parents_[index].load(memory_order_relaxed);
+    __builtin_prefetch(&parents_[index]);
+  }
+  // Return the number of vertices, including virtual vertices.
+  Vertex size() const { return parents_.size(); }
+
+ private:
+  // Return root index of the given index.
+  Vertex find_index(Vertex index);
+  // Return whether index1 has lower linking priority than index2.
+  static bool lower_priority(Vertex index1, Vertex index2) {
+    uint64_t priority1 = priority(index1), priority2 = priority(index2);
+    return priority1 < priority2 ||
+      (priority1 == priority2 && index1 < index2);
+  }
+  // Return linking priority of the given index.
+  static uint64_t priority(Vertex index) {
+    uint64_t x = index + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+  // Return index of the given vertex in the parents.
+  Vertex to_index(Vertex vertex) const {
+    assert(-virtual_vertices_ <= vertex &&
+	   vertex < size() - virtual_vertices_);
+    return vertex + virtual_vertices_;
+  }
+  // Return vertex of the given index in the parents.
+  Vertex to_vertex(Vertex index) const { return index - virtual_vertices_; }
+  // Parent index of each index.  Roots are their own parents.
+  vector<atomic<Vertex> > parents_;
+  // Number of virtual vertices, which come first in the parents.
+  Vertex virtual_vertices_;
+};
+
+#endif // CONCURRENT_UNION_FIND_H_
@@ -0,0 +1,161 @@
+// Unit tests for concurrent union-find data structure using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "concurrent_union_find.h"
+#include "union_find.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+const int THREADS = 4;   // Threads of the stress tests.
+
+// Return random vertex pairs of the given universe.
+static vector<pair<Vertex, Vertex> > random_pairs(Vertex universe, int size,
+						  unsigned seed) {
+  mt19937 generator(seed);
+  uniform_int_distribution<Vertex> distribution(0, universe - 1);
+  vector<pair<Vertex, Vertex> > pairs;
+  for(int i = 0; i < size; i++) {
+    Vertex vertex1 = distribution(generator);
+    pairs.push_back(make_pair(vertex1, distribution(generator)));
+  }
+  return pairs;
+}
+
+TEST(concurrent_union_find_test_suite, test_sequential) {
+  ConcurrentUnionFind uf = ConcurrentUnionFind(10, 2);
+  EXPECT_EQ(12, uf.size()) << "Size should include virtual vertices.";
+  for(Vertex v = -2; v < 10; v++)
+    EXPECT_EQ(v, uf.find(v)) << "vertex: " << v << " should be a root.";
+  EXPECT_TRUE(uf.join(-1, 0)) << "Join of new sets should link.";
+  EXPECT_TRUE(uf.join(9, -2)) << "Join of new sets should link.";
+  EXPECT_FALSE(uf.connected(-1, -2)) << "Borders should not be joined.";
+  EXPECT_TRUE(uf.join(0, 5));
+  EXPECT_TRUE(uf.join(5, 9));
+  EXPECT_FALSE(uf.join(-1, 9)) << "Join of one set should not link.";
+  EXPECT_TRUE(uf.connected(-1, -2)) << "Borders should be joined.";
+  EXPECT_EQ(uf.find(-1), uf.find(-2)) << "Roots should match.";
+  uf.clear();
+  EXPECT_FALSE(uf.connected(0, 5)) << "Clear should split sets.";
+}
+
+TEST(concurrent_union_find_test_suite, test_concurrent_joins) {
+  const Vertex universe = 20000;
+  vector<pair<Vertex, Vertex> > pairs = random_pairs(universe, 15000, 7);
+  ConcurrentUnionFind uf = ConcurrentUnionFind(universe);
+  UnionFind oracle = UnionFind(universe);
+  atomic<int> links(0);
+  vector<thread> workers;
+
+  // Threads join interleaved slices of the pairs, and every thread also
+  // joins the first pairs to race on the same roots.
+  for(int t = 0; t < THREADS; t++)
+    workers.push_back(thread([&, t]() {
+	  int linked = 0;
+	  for(size_t i = t; i < pairs.size(); i += THREADS)
+	    linked += uf.join(pairs[i].first, pairs[i].second);
+	  for(int i = 0; i < 1000; i++)
+	    linked += uf.join(pairs[i].second, pairs[i].first);
+	  links += linked;
+	}));
+  for(auto& worker: workers)
+    worker.join();
+
+  // Components match the sequential oracle, and each link merged two
+  // distinct sets exactly once.
+  int merges = 0;
+  for(auto& pair: pairs) {
+    merges += oracle.find(pair.first) != oracle.find(pair.second);
+    oracle.join(pair.first, pair.second);
+  }
+  EXPECT_EQ(merges, links.load()) << "Links should match oracle merges.";
+  for(Vertex v = 0; v < universe; v++)
+    ASSERT_EQ(oracle.find(v) == oracle.find(pairs[v % pairs.size()].first),
+	      uf.find(v) == uf.find(pairs[v % pairs.size()].first))
+      << "Component is wrong for vertex: " << v;
+  for(Vertex v = 1; v < universe; v++)
+    ASSERT_EQ(oracle.find(v) == oracle.find(v - 1), uf.connected(v, v - 1))
+      << "Connectivity is wrong for vertex: " << v;
+}
+
+TEST(concurrent_union_find_test_suite, test_concurrent_queries) {
+  // Readers check that connectivity only grows while writers join a
+  // chain in opposite orders.
+  const Vertex universe = 5000;
+  ConcurrentUnionFind uf = ConcurrentUnionFind(universe);
+  atomic<bool> done(false), monotone(true);
+  vector<thread> workers;
+
+  for(int t = 0; t < 2; t++)
+    workers.push_back(thread([&, t]() {
+	  for(Vertex i = 1; i < universe; i++) {
+	    Vertex v = t ? universe - i : i;
+	    uf.join(v, v - 1);
+	  }
+	}));
+  thread reader([&]() {
+      vector<bool> seen(universe, false);
+      while(!done)
+	for(Vertex v = 1; v < universe; v += 97) {
+	  bool now = uf.connected(0, v);
+	  if(seen[v] && !now)
+	    monotone = false;
+	  seen[v] = seen[v] || now;
+	}
+    });
+  for(auto& worker: workers)
+    worker.join();
+  done = true;
+  reader.join();
+  EXPECT_TRUE(monotone.load()) << "Connectivity should never shrink.";
+  Vertex root = uf.find(0);
+  for(Vertex v = 0; v < universe; v++)
+    ASSERT_EQ(root, uf.find(v)) << "Chain should be one set at: " << v;
+}
+
+TEST(concurrent_union_find_test_suite, test_concurrent_finds) {
+  // Threads split the paths of a deep chain at the same time, and every
+  // find must still return the root.  Joining the vertices in order of
+  // priority links each root under the next vertex, so the chain is as
+  // deep as the universe.
+  const Vertex universe = 1 << 18;
+  const int threads = 4, rounds = 4;
+  ConcurrentUnionFind uf = ConcurrentUnionFind(universe);
+  vector<Vertex> chain(universe);
+  for(Vertex v = 0; v < universe; v++)
+    chain[v] = v;
+  sort(chain.begin(), chain.end(), [&](Vertex v1, Vertex v2) {
+      return uf.links_under(v1, v2);
+    });
+  const Vertex root = chain.back();
+
+  for(int round = 0; round < rounds; round++) {
+    uf.clear();
+    for(Vertex i = 1; i < universe; i++)
+      ASSERT_TRUE(uf.join(chain[i - 1], chain[i]));
+    atomic<int> ready(0);
+    atomic<int> wrong(0);
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++)
+      workers.push_back(thread([&, t]() {
+	    ready++;
+	    while(ready < threads)
+	      ;
+	    for(Vertex i = t; i < universe; i += universe / 64)
+	      if(uf.find(chain[i]) != root)
+		wrong++;
+	  }));
+    for(auto& worker: workers)
+      worker.join();
+    EXPECT_EQ(0, wrong.load()) << "Finds should return the root: " << round;
+    EXPECT_TRUE(uf.connected(chain[0], chain[universe / 2]))
+      << "Chain should be one set.";
+  }
+}
@@ -0,0 +1,165 @@
+// Implement parallel connected-components labeling.
+
+#include "connected_components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const unsigned SAMPLE_SEED = 1;   // Seed of the sampled vertices.
+
+// Run function(begin, end) on all chunks of COMPONENT_CHUNK vertices of
+// [0, vertices) on the given number of threads.  Threads take chunks from
+// a shared counter, so vertices of high degree do not hold up a thread
+// with a fixed share.
+static void parallel_for(int vertices, int threads,
+			 const function<void(int, int)>& function) {
+  atomic<int> next(0);
+  vector<thread> workers;
+  auto work = [&]() {
+    int begin;
+    while((begin = next.fetch_add(COMPONENT_CHUNK)) < vertices)
+      function(begin, min(begin + COMPONENT_CHUNK, vertices));
+  };
+
+  threads = min(threads, (vertices + COMPONENT_CHUNK - 1) / COMPONENT_CHUNK);
+  if(threads <= 1) {
+    work();
+    return;
+  }
+  for(int i = 0; i < threads; i++)
+    workers.push_back(thread(work));
+  for(auto& worker: workers)
+    worker.join();
+}
+
+// Prefetch the entries that the join of a vertex with its i-th neighbor
+// reads, as in UnionFind::find_many(): the entry of the neighbor of the
+// vertex 2 * FIND_PREFETCH ahead, and the parent entries of the vertex
+// and of the neighbor FIND_PREFETCH ahead, whose own entries are in cache
+// by then.
+static void prefetch_join(const CsrGraph& graph,
+			  const ConcurrentUnionFind& components, int vertex,
+			  int64_t i, int end) {
+  int ahead = vertex + 2 * FIND_PREFETCH;
+
+  if(ahead < end && graph.degree(ahead) > i)
+    components.prefetch(graph.neighbor(ahead, i));
+  ahead = vertex + FIND_PREFETCH;
+  if(ahead < end) {
+    components.prefetch(ahead, true);
+    if(graph.degree(ahead) > i)
+      components.prefetch(graph.neighbor(ahead, i), true);
+  }
+}
+
+// =====================
+//  ConnectedComponents
+// =====================
+
+// Label the components of the given graph.
+ConnectedComponents::ConnectedComponents(const CsrGraph& graph, int threads)
+  : graph_(graph),
+    labels_(graph.vertices()),
+    sizes_({}),
+    threads_(threads) {
+  ConcurrentUnionFind components = ConcurrentUnionFind(graph.vertices());
+  vector<int> root_labels(graph.vertices(), -1);
+
+  if(threads_ <= 0)
+    threads_ = max(1u, thread::hardware_concurrency());
+
+  // Link each vertex to its first neighbors, one round at a time, so
+  // that every round joins a sparse forest, and flatten the trees after
+  // each round, so that the joins of the next one take two hops.
+  for(int round = 0; round < NEIGHBOR_ROUNDS; round++) {
+    parallel_for(graph_.vertices(), threads_, [&](int begin, int end) {
+	for(int vertex = begin; vertex < end; vertex++) {
+	  prefetch_join(graph_, components, vertex, round, end);
+	  if(graph_.degree(vertex) > round)
+	    components.join(vertex, graph_.neighbor(vertex, round));
+	}
+      });
+    find_roots(components);
+  }
+
+  // Link the rest outside the giant component.
+  link_remaining(components, sample_root(components));
+
+  // Number the final roots in vertex order.  All joins are done by now,
+  // so the roots stored by find_roots() are final; the sequential find
+  // confirms each one and costs a single load on the flat trees.
+  find_roots(components);
+  for(int vertex = 0; vertex < graph_.vertices(); vertex++) {
+    int& label = root_labels[components.find(labels_[vertex])];
+    if(label < 0) {
+      label = sizes_.size();
+      sizes_.push_back(0);
+    }
+    labels_[vertex] = label;
+    sizes_[label]++;
+  }
+}
+
+// Store the root of each vertex in its label.  Finds split the paths on
+// the way, so trees are flat afterwards.
+void ConnectedComponents::find_roots(ConcurrentUnionFind& components) {
+  parallel_for(graph_.vertices(), threads_, [&](int begin, int end) {
+      for(int vertex = begin; vertex < end; vertex++) {
+	if(vertex + FIND_PREFETCH < end)
+	  components.prefetch(vertex + FIND_PREFETCH, true);
+	labels_[vertex] = components.find(vertex);
+      }
+    });
+}
+
+// Link every vertex outside the component of the given root to its
+// remaining neighbors.  The root may be linked under another root by a
+// concurrent join, after which its vertices are no longer skipped, which
+// costs time but not correctness.
+void ConnectedComponents::link_remaining(ConcurrentUnionFind& components,
+					 Vertex skip_root) {
+  parallel_for(graph_.vertices(), threads_, [&](int begin, int end) {
+      for(int vertex = begin; vertex < end; vertex++) {
+	if(vertex + FIND_PREFETCH < end)
+	  components.prefetch(vertex + FIND_PREFETCH, true);
+	if(graph_.degree(vertex) <= NEIGHBOR_ROUNDS ||
+	   components.find(vertex) == skip_root)
+	  continue;
+	for(int64_t i = NEIGHBOR_ROUNDS; i < graph_.degree(vertex); i++)
+	  components.join(vertex, graph_.neighbor(vertex, i));
+      }
+    });
+}
+
+// Return the most frequent root of sampled vertices, or -1 for a graph
+// without vertices.
+Vertex ConnectedComponents::sample_root(ConcurrentUnionFind& components)
+  const {
+  mt19937 generator(SAMPLE_SEED);
+  vector<Vertex> roots;
+  Vertex root = -1;
+  int count = 0;
+
+  if(graph_.vertices() == 0)
+    return root;
+  uniform_int_distribution<int> distribution(0, graph_.vertices() - 1);
+  for(int i = 0; i < COMPONENT_SAMPLES; i++)
+    roots.push_back(components.find(distribution(generator)));
+  sort(roots.begin(), roots.end());
+  const int samples = roots.size();
+  for(int begin = 0, end; begin < samples; begin = end) {
+    for(end = begin; end < samples && roots[end] == roots[begin]; end++)
+      ;
+    if(end - begin > count) {
+      root = roots[begin];
+      count = end - begin;
+    }
+  }
+  return root;
+}
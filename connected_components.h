@@ -0,0 +1,119 @@
+// Header file for parallel connected-components labeling.
+
+#ifndef CONNECTED_COMPONENTS_H_
+#define CONNECTED_COMPONENTS_H_
+
+#include "concurrent_union_find.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+const int COMPONENT_CHUNK = 4096;   // Vertices per task of a parallel pass.
+const int COMPONENT_SAMPLES = 1024; // Vertices sampled for the giant root.
+const int NEIGHBOR_ROUNDS = 2;      // Neighbors linked before sampling.
+
+// Undirected graph in compressed sparse row form, for vertices 0 to
+// vertices - 1.  The neighbors of each vertex are stored contiguously,
+// and each edge is stored in both directions.  The graph is built from
+// any list of edges with vertex1 and vertex2 members, such as the Edge of
+// Prim, e.g. from Graph::get_edges() or Graph::read_edges().
+class CsrGraph {
+ public:
+  // Construct the graph from the given edges.  Neighbors keep the order
+  // of the edges.
+  template <class EdgeList>
+  CsrGraph(int vertices, const EdgeList& edges)
+    : offsets_(vertices + 1, 0) {
+    vector<int64_t> next;
+
+    for(auto& edge: edges) {
+      assert(0 <= edge.vertex1 && edge.vertex1 < vertices);
+      assert(0 <= edge.vertex2 && edge.vertex2 < vertices);
+      offsets_[edge.vertex1 + 1]++;
+      offsets_[edge.vertex2 + 1]++;
+    }
+    for(int vertex = 0; vertex < vertices; vertex++)
+      offsets_[vertex + 1] += offsets_[vertex];
+    neighbors_.resize(offsets_[vertices]);
+    next.assign(offsets_.begin(), offsets_.end() - 1);
+    for(auto& edge: edges) {
+      neighbors_[next[edge.vertex1]++] = edge.vertex2;
+      neighbors_[next[edge.vertex2]++] = edge.vertex1;
+    }
+  }
+  // Return the degree of the given vertex.
+  int64_t degree(int vertex) const {
+    return offsets_[vertex + 1] - offsets_[vertex];
+  }
+  // Return the number of undirected edges.
+  int64_t edges() const { return neighbors_.size() / 2; }
+  // Return the i-th neighbor of the given vertex.
+  int neighbor(int vertex, int64_t i) const {
+    return neighbors_[offsets_[vertex] + i];
+  }
+  // Return the number of vertices.
+  int vertices() const { return offsets_.size() - 1; }
+
+ private:
+  // Neighbors of all vertices, vertex by vertex.
+  vector<int> neighbors_;
+  // Offset of the first neighbor of each vertex, and the total number
+  // of neighbors at the end.
+  vector<int64_t> offsets_;
+};
+
+// A class to label the connected components of a graph in parallel with
+// the Afforest algorithm (Sutton, Ben-Nun & Barak, Optimizing parallel
+// graph connectivity computation via subgraph sampling, IPDPS 2018), a
+// sampling refinement of Shiloach-Vishkin linking on a concurrent
+// union-find:
+// - Each vertex links to its first NEIGHBOR_ROUNDS neighbors, which
+//   already merges most of the giant component of a typical graph.
+// - The most frequent root among COMPONENT_SAMPLES random vertices is
+//   taken as the giant component.
+// - The remaining vertices link to their remaining neighbors.  Vertices
+//   of the giant component are skipped, since every edge leaving it is
+//   also stored at its other endpoint.
+// Most edges of the giant component are never visited, so the cost is
+// far below one join per edge.  Like MstVerifier, the instance does all
+// the work in its constructor.
+//
+// Labels are dense, from 0 to component_count() - 1, and numbered in the
+// order of the smallest vertex of each component, so they do not depend
+// on the number of threads.
+class ConnectedComponents {
+ public:
+  // Label the components of the given graph.  If threads is 0, use the
+  // number of hardware threads.
+  ConnectedComponents(const CsrGraph& graph, int threads=0);
+  // Return the number of components.
+  int component_count() const { return sizes_.size(); }
+  // Return component label of the given vertex.
+  int label(int vertex) const { return labels_[vertex]; }
+  // Return component label of each vertex.
+  const vector<int>& labels() const { return labels_; }
+  // Return size of each component by label.
+  const vector<int>& sizes() const { return sizes_; }
+
+ private:
+  // Store the root of each vertex in its label.
+  void find_roots(ConcurrentUnionFind& components);
+  // Link every vertex outside the component of the given root to its
+  // neighbors after the first NEIGHBOR_ROUNDS.
+  void link_remaining(ConcurrentUnionFind& components, Vertex skip_root);
+  // Return the most frequent root of sampled vertices.
+  Vertex sample_root(ConcurrentUnionFind& components) const;
+  // Graph to label.
+  const CsrGraph& graph_;
+  // Component label of each vertex.
+  vector<int> labels_;
+  // Size of each component by label.
+  vector<int> sizes_;
+  // Number of worker threads.
+  int threads_;
+};
+
+#endif // CONNECTED_COMPONENTS_H_
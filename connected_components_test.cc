@@ -0,0 +1,91 @@
+// Unit tests for parallel connected-components labeling using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "connected_components.h"
+#include "prim.h"
+#include "union_find.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Return random edges of the given number of vertices.
+static vector<Edge> random_edges(int vertices, int size, unsigned seed) {
+  mt19937 generator(seed);
+  uniform_int_distribution<int> distribution(0, vertices - 1);
+  vector<Edge> edges;
+  for(int i = 0; i < size; i++) {
+    int vertex1 = distribution(generator);
+    edges.push_back(Edge{ vertex1, distribution(generator), 1.0 });
+  }
+  return edges;
+}
+
+TEST(connected_components_test_suite, test_csr_graph) {
+  vector<Edge> edges = { { 0, 1, 1.0 }, { 2, 0, 1.0 }, { 3, 3, 1.0 } };
+  CsrGraph graph = CsrGraph(5, edges);
+  EXPECT_EQ(5, graph.vertices()) << "Vertex count is wrong.";
+  EXPECT_EQ(3, graph.edges()) << "Edge count is wrong.";
+  EXPECT_EQ(2, graph.degree(0)) << "Degree of 0 is wrong.";
+  EXPECT_EQ(1, graph.neighbor(0, 0)) << "Neighbors should keep edge order.";
+  EXPECT_EQ(2, graph.neighbor(0, 1)) << "Neighbors should keep edge order.";
+  EXPECT_EQ(0, graph.neighbor(2, 0)) << "Edge should be stored both ways.";
+  EXPECT_EQ(2, graph.degree(3)) << "Self loop should be stored twice.";
+  EXPECT_EQ(0, graph.degree(4)) << "Vertex 4 should be isolated.";
+}
+
+TEST(connected_components_test_suite, test_small_graph) {
+  // Components {0, 3, 5}, {1}, {2, 4, 6, 7} with a self loop on 1.
+  Graph graph = Graph();
+  graph.add_edge(0, 3, 1.0);
+  graph.add_edge(5, 3, 2.0);
+  graph.add_edge(2, 4, 1.0);
+  graph.add_edge(4, 6, 1.0);
+  graph.add_edge(7, 2, 1.0);
+  graph.add_edge(6, 7, 1.0);
+  graph.add_edge(1, 1, 1.0);
+  ConnectedComponents components = ConnectedComponents(
+      CsrGraph(8, graph.get_edges()), 2);
+  vector<int> labels = { 0, 1, 2, 0, 2, 0, 2, 2 };
+  vector<int> sizes = { 3, 1, 4 };
+  EXPECT_EQ(3, components.component_count()) << "Count is wrong.";
+  EXPECT_EQ(labels, components.labels())
+    << "Labels should follow the smallest vertices.";
+  EXPECT_EQ(sizes, components.sizes()) << "Sizes are wrong.";
+  EXPECT_EQ(2, components.label(7)) << "Label of 7 is wrong.";
+
+  ConnectedComponents empty = ConnectedComponents(
+      CsrGraph(0, vector<Edge>()));
+  EXPECT_EQ(0, empty.component_count()) << "Empty graph has no components.";
+}
+
+TEST(connected_components_test_suite, test_random_graphs) {
+  // Sparse graphs have many components; dense ones have a giant one.
+  const int vertices = 50000;
+  for(int size: { 10000, 30000, 200000 }) {
+    vector<Edge> edges = random_edges(vertices, size, size);
+    CsrGraph graph = CsrGraph(vertices, edges);
+    UnionFind oracle = UnionFind(vertices);
+    for(auto& edge: edges)
+      oracle.join(edge.vertex1, edge.vertex2);
+    ConnectedComponents expect = ConnectedComponents(graph, 1);
+    ASSERT_EQ(oracle.component_count(), expect.component_count())
+      << "Count should match the oracle for edges: " << size;
+    int total = 0;
+    for(int vertex = 0; vertex < vertices; vertex++) {
+      ASSERT_EQ(oracle.component_size(vertex),
+		expect.sizes()[expect.label(vertex)])
+	<< "Size is wrong for vertex: " << vertex;
+      total += oracle.find(vertex) == oracle.find(0);
+    }
+    EXPECT_EQ(total, expect.sizes()[expect.label(0)])
+      << "Component of 0 is wrong for edges: " << size;
+    for(int threads = 2; threads <= 4; threads++) {
+      ConnectedComponents components = ConnectedComponents(graph, threads);
+      EXPECT_EQ(expect.labels(), components.labels())
+	<< "Labels should not depend on threads: " << threads;
+    }
+  }
+}
@@ -3,9 +3,12 @@
 
 #include "dijkstra.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <functional>
 #include <iostream>
 #include <unordered_set>
+#include <vector>
 
 using namespace std;
 
@@ -231,3 +234,100 @@ unordered_map<int, double> Dijkstra::shortest_paths(int source) {
   }
   return spaths;
 }
+
+// ================
+//  AdjacencyGraph
+// ================
+
+// Add an edge to the graph.  Edge from a vertex to itself is not supported.
+void AdjacencyGraph::add_edge(int vertex1, int vertex2, double distance) {
+
+  // Don't add an edge from a vertex to itself.
+  if(vertex1 == vertex2)
+    return;
+  adjacency_[vertex1].push_back({ vertex2, distance });
+  adjacency_[vertex2].push_back({ vertex1, distance });
+}
+
+// ===================
+//  AdjacencyDijkstra
+// ===================
+
+// Add edge to the graph and update the shortest-path distances.
+void AdjacencyDijkstra::insert_edge(AdjacencyGraph& graph, int vertex1,
+				    int vertex2, double distance,
+				    vector<double>& distances) {
+  greater<HeapEntry> order;
+  double priority;
+  int vertex;
+
+  graph.add_edge(vertex1, vertex2, distance);
+  if(vertex1 == vertex2)
+    return;
+  heap_.clear();
+  if(distances[vertex1] != NO_PATH)
+    relax(vertex2, distances[vertex1] + distance, distances);
+  if(distances[vertex2] != NO_PATH)
+    relax(vertex1, distances[vertex2] + distance, distances);
+  while(!heap_.empty()) {
+    pop_heap(heap_.begin(), heap_.end(), order);
+    priority = heap_.back().first;
+    vertex = heap_.back().second;
+    heap_.pop_back();
+
+    // Skip stale entry whose vertex has dropped further since.
+    if(priority > distances[vertex])
+      continue;
+    for(auto& neighbor: graph.neighbors(vertex))
+      relax(neighbor.vertex, priority + neighbor.distance, distances);
+  }
+}
+
+// Lower the distance of the given vertex if the new distance is shorter.
+void AdjacencyDijkstra::relax(int vertex, double distance,
+			      vector<double>& distances) {
+  if(distances[vertex] != NO_PATH && distances[vertex] <= distance)
+    return;
+  distances[vertex] = distance;
+  heap_.push_back(HeapEntry(distance, vertex));
+  push_heap(heap_.begin(), heap_.end(), greater<HeapEntry>());
+}
+
+// Compute shortest paths from the given source.
+void AdjacencyDijkstra::shortest_paths(const AdjacencyGraph& graph,
+				       int source,
+				       vector<double>& distances) {
+  greater<HeapEntry> order;
+  double distance;
+  int vertex;
+
+  distances.assign(graph.capacity(), NO_PATH);
+  closest_.assign(graph.capacity(), false);
+  heap_.clear();
+  heap_.push_back(HeapEntry(0.0, source));
+  distances[source] = 0.0;
+  while(!heap_.empty()) {
+    pop_heap(heap_.begin(), heap_.end(), order);
+    distance = heap_.back().first;
+    vertex = heap_.back().second;
+    heap_.pop_back();
+
+    // Skip stale entry of a vertex that is already a closest one.
+    if(closest_[vertex])
+      continue;
+    closest_[vertex] = true;
+
+    // Explore all edges from this vertex.
+    for(auto& neighbor: graph.neighbors(vertex)) {
+      double priority = distance + neighbor.distance;
+      double& current = distances[neighbor.vertex];
+      if(closest_[neighbor.vertex])
+	continue;
+      if(current != NO_PATH && current <= priority)
+	continue;
+      current = priority;
+      heap_.push_back(HeapEntry(priority, neighbor.vertex));
+      push_heap(heap_.begin(), heap_.end(), order);
+    }
+  }
+}
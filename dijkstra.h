@@ -9,6 +9,14 @@
 
 using namespace std;
 const int MAX_VERTICES = 50;     // Maximum amount of vertices.
+const double NO_PATH = -1.0;     // Distance of unreachable vertex.
+
+// Neighbor encapsulates the neighbor vertex and distance of an edge in
+// adjacency lists.
+struct Neighbor {
+  int vertex;
+  double distance;
+};
 
 // Queue element encapsulates the priority and vertex ID of element
 // that will be inserted into the priority queue. 
@@ -168,4 +176,70 @@ class Dijkstra {
   PriorityQueue priority_queue_;
 };
 
+// Graph representation with adjacency lists indexed by vertex, for
+// vertices 0 to capacity-1.  Unlike Graph, it does not check for
+// duplicate edges.  reset() removes all edges but keeps the capacity of
+// the lists, so a graph rebuilt with a similar amount of edges does not
+// allocate memory.
+class AdjacencyGraph {
+ public:
+  // Construct the graph for the given vertex capacity.
+  AdjacencyGraph(int capacity)
+    : adjacency_(capacity) {}
+  // Add edge to the graph.  Edge from a vertex to itself is not supported.
+  void add_edge(int vertex1, int vertex2, double distance=0);
+  // Return the vertex capacity of the graph.
+  int capacity() const { return adjacency_.size(); }
+  // Return neighbors of the given vertex.
+  const vector<Neighbor>& neighbors(int vertex) const {
+    return adjacency_[vertex];
+  }
+  // Remove all edges.
+  void reset() {
+    for(auto& neighbors: adjacency_)
+      neighbors.clear();
+  }
+
+ private:
+  // Adjacency list of each vertex.
+  vector<vector<Neighbor> > adjacency_;
+};
+
+// A class to compute single-source shortest-paths in AdjacencyGraph using
+// Dijkstra algorithm.  The instance owns its heap and closest flags and
+// reuses them across runs, so repeated runs do not allocate memory once
+// the heap has grown to its working size.  The heap allows duplicate
+// vertices and skips the stale entries instead of changing priorities.
+class AdjacencyDijkstra {
+ public:
+  // Construct the Dijkstra algorithm instance for the given vertex
+  // capacity.
+  AdjacencyDijkstra(int capacity)
+    : closest_(capacity, false),
+      heap_({}) {
+    heap_.reserve(capacity);
+  }
+  // Add edge to the graph and update the shortest-path distances from
+  // an earlier call to shortest_paths() or insert_edge().  Since adding
+  // an edge only shortens paths, only vertices whose distances drop are
+  // explored again.
+  void insert_edge(AdjacencyGraph& graph, int vertex1, int vertex2,
+		   double distance, vector<double>& distances);
+  // Compute shortest paths from the given source into distances, which
+  // is indexed by vertex.  Unreachable vertices get NO_PATH.
+  void shortest_paths(const AdjacencyGraph& graph, int source,
+		      vector<double>& distances);
+
+ private:
+  // Heap entry with the distance and the vertex.
+  typedef pair<double, int> HeapEntry;
+  // Lower the distance of the given vertex if the new distance is
+  // shorter and push it onto the heap.
+  void relax(int vertex, double distance, vector<double>& distances);
+  // Closest flag of each vertex.
+  vector<bool> closest_;
+  // Binary min-heap of entries.
+  vector<HeapEntry> heap_;
+};
+
 #endif // DIJKSTRA_H_
@@ -271,3 +271,54 @@ TEST(dijkstra_test_suite, test_graph3) {
     {6, 11.0}};
   check_dijkstra_results(1, distance_map, results);
 }
+
+TEST(adjacency_dijkstra_test_suite, test_graph3) {
+  AdjacencyGraph graph = AdjacencyGraph(8);
+  AdjacencyDijkstra dsa = AdjacencyDijkstra(8);
+  vector<double> results;
+  vector<double> expect = { NO_PATH, 0.0, 7.0, 9.0, 20.0, 20.0, 11.0,
+			    NO_PATH };
+
+  graph.add_edge(1, 2, 7);
+  graph.add_edge(1, 3, 9);
+  graph.add_edge(1, 6, 14);
+  graph.add_edge(2, 3, 10);
+  graph.add_edge(2, 4, 15);
+  graph.add_edge(3, 4, 11);
+  graph.add_edge(3, 6, 2);
+  graph.add_edge(4, 5, 6);
+  graph.add_edge(5, 6, 9);
+  graph.add_edge(7, 7, 1);
+  dsa.shortest_paths(graph, 1, results);
+  EXPECT_TRUE(expect == results) << "Shortest paths from 1 are wrong.";
+
+  // Rebuild graph after reset.
+  graph.reset();
+  graph.add_edge(1, 7, 3);
+  dsa.shortest_paths(graph, 7, results);
+  expect = { NO_PATH, 3.0, NO_PATH, NO_PATH, NO_PATH, NO_PATH, NO_PATH,
+	     0.0 };
+  EXPECT_TRUE(expect == results) << "Shortest paths after reset are wrong.";
+}
+
+TEST(adjacency_dijkstra_test_suite, test_insert_edge) {
+  AdjacencyGraph graph = AdjacencyGraph(7);
+  AdjacencyGraph rebuilt = AdjacencyGraph(7);
+  AdjacencyDijkstra dsa = AdjacencyDijkstra(7);
+  vector<double> results(7, NO_PATH), expect;
+  vector<Neighbor> edges = {{ 2, 7 }, { 3, 9 }, { 6, 14 }, { 3, 10 },
+			    { 4, 15 }, { 4, 11 }, { 6, 2 }, { 5, 6 },
+			    { 6, 9 }};
+  vector<int> sources = { 1, 1, 1, 2, 2, 3, 3, 4, 5 };
+
+  // Distances after each insertion should match a full computation.
+  results[1] = 0.0;
+  for(size_t i = 0; i < edges.size(); i++) {
+    dsa.insert_edge(graph, sources[i], edges[i].vertex, edges[i].distance,
+		    results);
+    rebuilt.add_edge(sources[i], edges[i].vertex, edges[i].distance);
+    dsa.shortest_paths(rebuilt, 1, expect);
+    EXPECT_TRUE(expect == results)
+      << "Distances are wrong after inserting edge: " << i;
+  }
+}
@@ -0,0 +1,305 @@
+// Homework 3
+// Implement Euclidean MST over point sets using Boruvka algorithm and
+// k-d tree.
+
+#include "euclidean_mst.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const double INFINITE_DISTANCE = numeric_limits<double>::infinity();
+
+// ==========
+//  PointSet
+// ==========
+
+// Add point with the given coordinates.
+void PointSet::add_point(const vector<double>& point) {
+  if(!dimension_)
+    dimension_ = point.size();
+  assert(dimension_ > 0 && int(point.size()) == dimension_);
+  coordinates_.insert(coordinates_.end(), point.begin(), point.end());
+}
+
+// Return the Euclidean distance between two points.
+double PointSet::distance(int point1, int point2) const {
+  return sqrt(squared_distance(point1, point2));
+}
+
+// Read point set from file.
+void PointSet::read_file(string& filename) {
+  string line;
+  double value;
+  ifstream my_file(filename);
+  assert(my_file.is_open());
+
+  // Get number of points.
+  getline(my_file, line);
+
+  // Iterate and read each point.
+  while(getline(my_file, line)) {
+    istringstream ss(line);
+    vector<double> point;
+    while(ss >> value)
+      point.push_back(value);
+
+    // Skip blank lines.
+    if(!point.empty())
+      add_point(point);
+  }
+}
+
+// Return the squared Euclidean distance between two points.
+double PointSet::squared_distance(int point1, int point2) const {
+  double delta, result = 0.0;
+
+  for(int axis = 0; axis < dimension_; axis++) {
+    delta = coordinate(point1, axis) - coordinate(point2, axis);
+    result += delta * delta;
+  }
+  return result;
+}
+
+// ========
+//  KdTree
+// ========
+
+// Construct the k-d tree for the given point set.
+KdTree::KdTree(const PointSet& points)
+  : components_(points.size(), -1),
+    indices_(points.size()),
+    points_(points) {
+  for(int i = 0; i < points.size(); i++)
+    indices_[i] = i;
+  if(points.size())
+    build(0, points.size());
+}
+
+// Return the squared distance from a point to the bounding box of the
+// given node.
+double KdTree::box_distance(int node, int point) const {
+  int dimension = points_.dimension();
+  const double* bounds = &bounds_[node * 2 * dimension];
+  double value, delta, result = 0.0;
+
+  for(int axis = 0; axis < dimension; axis++) {
+    value = points_.coordinate(point, axis);
+    delta = 0.0;
+    if(value < bounds[2*axis])
+      delta = bounds[2*axis] - value;
+    else if(value > bounds[2*axis + 1])
+      delta = value - bounds[2*axis + 1];
+    result += delta * delta;
+  }
+  return result;
+}
+
+// Recursively build the subtree over indices_[begin, end).
+int KdTree::build(int begin, int end) {
+  int dimension = points_.dimension();
+  int node = nodes_.size();
+  int split_axis = 0, middle, left, right;
+  double value, widest = -1.0;
+  KdNode this_node = { begin, end, -1, -1, -1 };
+
+  // Compute the bounding box and its widest axis.
+  nodes_.push_back(this_node);
+  for(int axis = 0; axis < dimension; axis++) {
+    double low = INFINITE_DISTANCE, high = -INFINITE_DISTANCE;
+    for(int i = begin; i < end; i++) {
+      value = points_.coordinate(indices_[i], axis);
+      low = min(low, value);
+      high = max(high, value);
+    }
+    bounds_.push_back(low);
+    bounds_.push_back(high);
+    if(high - low > widest) {
+      widest = high - low;
+      split_axis = axis;
+    }
+  }
+  if(end - begin <= KD_LEAF_SIZE)
+    return node;
+
+  // Split at the median of the widest axis.
+  middle = begin + (end - begin) / 2;
+  nth_element(indices_.begin() + begin,
+	      indices_.begin() + middle,
+	      indices_.begin() + end,
+	      [this, split_axis](int point1, int point2) {
+		return points_.coordinate(point1, split_axis) <
+		  points_.coordinate(point2, split_axis);
+	      });
+  left = build(begin, middle);
+  right = build(middle, end);
+  nodes_[node].left = left;
+  nodes_[node].right = right;
+  return node;
+}
+
+// Check if the given candidate is closer than the current best.  Without
+// any best point, the best distance is only a bound, which a candidate
+// at the same distance still matches.
+bool KdTree::closer(int point, double distance, int candidate,
+		    double best_distance, int best_point) const {
+  if(distance != best_distance)
+    return distance < best_distance;
+  if(best_point < 0)
+    return true;
+  return make_pair(min(point, candidate), max(point, candidate)) <
+    make_pair(min(point, best_point), max(point, best_point));
+}
+
+// Find the nearest point to the given point outside of its component.
+void KdTree::nearest_outside(int point, double& best_distance,
+			     int& best_point) const {
+  if(!nodes_.empty())
+    search(0, point, components_[point], best_distance, best_point);
+}
+
+// Search the given subtree for the nearest point outside of the
+// component.
+void KdTree::search(int node, int point, int component,
+		    double& best_distance, int& best_point) const {
+  const KdNode& this_node = nodes_[node];
+  double distance;
+  int candidate;
+
+  // Prune subtree inside the component or beyond the best distance.
+  if(this_node.component == component)
+    return;
+  if(box_distance(node, point) > best_distance)
+    return;
+
+  // Scan points of leaf node.
+  if(this_node.left < 0) {
+    for(int i = this_node.begin; i < this_node.end; i++) {
+      candidate = indices_[i];
+      if(components_[candidate] == component)
+	continue;
+      distance = points_.squared_distance(point, candidate);
+      if(closer(point, distance, candidate, best_distance, best_point)) {
+	best_distance = distance;
+	best_point = candidate;
+      }
+    }
+    return;
+  }
+
+  // Visit the nearer child first.
+  if(box_distance(this_node.left, point) <=
+     box_distance(this_node.right, point)) {
+    search(this_node.left, point, component, best_distance, best_point);
+    search(this_node.right, point, component, best_distance, best_point);
+  } else {
+    search(this_node.right, point, component, best_distance, best_point);
+    search(this_node.left, point, component, best_distance, best_point);
+  }
+}
+
+// Update node components from the component of each point.
+void KdTree::update_components(const vector<int>& components) {
+  components_ = components;
+
+  // Children follow their parents, so a reverse scan visits them first.
+  for(int node = nodes_.size() - 1; node >= 0; node--) {
+    KdNode& this_node = nodes_[node];
+    if(this_node.left >= 0) {
+      int left = nodes_[this_node.left].component;
+      int right = nodes_[this_node.right].component;
+      this_node.component = left == right ? left : -1;
+      continue;
+    }
+    this_node.component = components_[indices_[this_node.begin]];
+    for(int i = this_node.begin + 1; i < this_node.end; i++)
+      if(components_[indices_[i]] != this_node.component) {
+	this_node.component = -1;
+	break;
+      }
+  }
+}
+
+// ==============
+//  EuclideanMst
+// ==============
+
+// Run one Boruvka round and add the selected edges to the MST.
+int EuclideanMst::boruvka_round(KdTree& tree, vector<int>& components,
+				Graph& mst) {
+  int size = points_.size();
+  int merges = 0;
+  Candidate none = { INFINITE_DISTANCE, -1, -1 };
+  vector<Candidate> best(size, none);
+
+  // Find the shortest outgoing edge of each component.  The component
+  // bound is shared by all of its points to prune the searches.
+  for(int point = 0; point < size; point++) {
+    Candidate& component_best = best[components[point]];
+    double distance = component_best.distance;
+    int nearest = -1;
+
+    tree.nearest_outside(point, distance, nearest);
+    if(nearest < 0)
+      continue;
+    Candidate candidate = { distance, min(point, nearest),
+			    max(point, nearest) };
+    if(component_best.point1 < 0 ||
+       make_pair(candidate.distance,
+		 make_pair(candidate.point1, candidate.point2)) <
+       make_pair(component_best.distance,
+		 make_pair(component_best.point1, component_best.point2)))
+      component_best = candidate;
+  }
+
+  // Merge components along the selected edges.  Components selecting
+  // the same edge are merged only once.
+  for(auto& candidate: best) {
+    if(candidate.point1 < 0)
+      continue;
+    if(union_find_.find(candidate.point1) ==
+       union_find_.find(candidate.point2))
+      continue;
+    union_find_.join(candidate.point1, candidate.point2);
+    mst.add_edge(candidate.point1, candidate.point2,
+		 sqrt(candidate.distance));
+    merges++;
+  }
+  for(int point = 0; point < size; point++)
+    components[point] = union_find_.find(point);
+  return merges;
+}
+
+// Compute and return MST.  The union-find starts over, so that every
+// call computes the MST from scratch.
+Graph EuclideanMst::mst() {
+  Graph euclidean_mst = Graph();
+  int size = points_.size();
+  int components_left = size;
+  vector<int> components(size);
+  KdTree tree = KdTree(points_);
+
+  // Each point starts in its own component.
+  union_find_.clear();
+  for(int point = 0; point < size; point++)
+    components[point] = union_find_.find(point);
+  while(components_left > 1) {
+    tree.update_components(components);
+    int merges = boruvka_round(tree, components, euclidean_mst);
+
+    // Every round with two components left merges some, so this should
+    // not occur.
+    assert(merges > 0);
+    if(!merges)
+      break;
+    components_left -= merges;
+  }
+  return euclidean_mst;
+}
@@ -0,0 +1,135 @@
+// Header file for Euclidean MST algorithm and its data structures.
+
+#ifndef EUCLIDEAN_MST_H_
+#define EUCLIDEAN_MST_H_
+
+#include "prim.h"
+#include "union_find.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+const int KD_LEAF_SIZE = 8;   // Maximum amount of points in k-d tree leaf.
+
+// A set of points with the same dimension.  Points are identified by
+// their positions in the input, starting from 0.
+class PointSet {
+ public:
+  // Construct an empty point set.
+  PointSet()
+    : coordinates_({}), dimension_(0) {}
+  // Construct the point set by reading from file.  The file format
+  // follows the graph data files: the first line is the number of
+  // points and each following line holds the space-separated
+  // coordinates of one point.
+  PointSet(string& filename)
+    : coordinates_({}), dimension_(0) { read_file(filename); }
+  // Add point with the given coordinates.  All points must share the
+  // dimension of the first point.
+  void add_point(const vector<double>& point);
+  // Return the coordinate of a point along the given axis.
+  double coordinate(int point, int axis) const {
+    return coordinates_[point*dimension_ + axis];
+  }
+  // Return the dimension of the points.
+  int dimension() const { return dimension_; }
+  // Return the Euclidean distance between two points.
+  double distance(int point1, int point2) const;
+  // Return the squared Euclidean distance between two points.
+  double squared_distance(int point1, int point2) const;
+  // Return the number of points.
+  int size() const {
+    return dimension_ ? coordinates_.size() / dimension_ : 0;
+  }
+
+ private:
+  // Read point set from file.
+  void read_file(string& filename);
+  // Coordinates of all points stored point by point.
+  vector<double> coordinates_;
+  // Dimension of the points.
+  int dimension_;
+};
+
+// A k-d tree over a point set.  Besides the bounding box of its points,
+// each node tracks the MST component shared by all of its points, or -1
+// if its points belong to different components.  This allows nearest
+// neighbor queries to skip whole subtrees that lie inside the
+// component of the query point.
+class KdTree {
+ public:
+  // Construct the k-d tree for the given point set.
+  KdTree(const PointSet& points);
+  // Find the nearest point to the given point outside of its component.
+  // The search only considers points closer than the incoming
+  // best_distance, which holds squared distances.  On improvement,
+  // best_distance and best_point are updated.  Ties are broken by the
+  // point order so that every query agrees on a single nearest point.
+  void nearest_outside(int point, double& best_distance,
+		       int& best_point) const;
+  // Update node components from the component of each point.
+  void update_components(const vector<int>& components);
+
+ private:
+  // Node of the k-d tree.  Points of the node are indices_[begin, end).
+  struct KdNode {
+    int begin, end;
+    int left, right;
+    int component;
+  };
+  // Recursively build the subtree over indices_[begin, end) and return
+  // its node identifier.
+  int build(int begin, int end);
+  // Return the squared distance from a point to the bounding box of
+  // the given node.
+  double box_distance(int node, int point) const;
+  // Check if the given candidate is closer than the current best.
+  bool closer(int point, double distance, int candidate,
+	      double best_distance, int best_point) const;
+  // Search the given subtree.  See nearest_outside().
+  void search(int node, int point, int component,
+	      double& best_distance, int& best_point) const;
+  // Bounding boxes stored node by node as (low, high) per axis.
+  vector<double> bounds_;
+  // Component of each point.
+  vector<int> components_;
+  // Point indices ordered by the tree layout.
+  vector<int> indices_;
+  // Tree nodes.  Parents always precede their children.
+  vector<KdNode> nodes_;
+  // Underlying point set.
+  const PointSet& points_;
+};
+
+// A class to compute Euclidean MST over a point set without building
+// the complete graph.  It runs Boruvka algorithm: every round finds,
+// for each component, its shortest edge to another component using
+// nearest neighbor queries on a k-d tree, and then merges the
+// components.  There are at most O(log N) rounds.
+class EuclideanMst {
+ public:
+  // Construct the Euclidean MST algorithm instance.
+  EuclideanMst(PointSet& points)
+    : points_(points), union_find_(UnionFind()) {}
+  // Compute and return MST as a graph whose vertices are the point
+  // indices and whose edge costs are the Euclidean distances.
+  Graph mst();
+
+ private:
+  // Candidate edge from a component to its nearest component.
+  struct Candidate {
+    double distance;
+    int point1, point2;
+  };
+  // Run one Boruvka round and add the selected edges to the MST.
+  // Return the number of merges.
+  int boruvka_round(KdTree& tree, vector<int>& components, Graph& mst);
+  // Underlying point set.
+  PointSet& points_;
+  // Union-find of the MST components.
+  UnionFind union_find_;
+};
+
+#endif // EUCLIDEAN_MST_H_
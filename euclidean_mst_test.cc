@@ -0,0 +1,92 @@
+// Unit tests for Euclidean MST algorithm and its data structures using
+// Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "euclidean_mst.h"
+#include "prim.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+
+const double TOLERANCE = 1e-9;
+
+// Generate random points in the unit cube of the given dimension.
+PointSet random_points(int size, int dimension, unsigned seed) {
+  default_random_engine generator(seed);
+  uniform_real_distribution<double> distribution(0.0, 1.0);
+  PointSet points = PointSet();
+
+  for(int i = 0; i < size; i++) {
+    vector<double> point;
+    for(int axis = 0; axis < dimension; axis++)
+      point.push_back(distribution(generator));
+    points.add_point(point);
+  }
+  return points;
+}
+
+// Compute MST cost with Prim algorithm over the complete graph.
+double complete_graph_mst_cost(const PointSet& points) {
+  Graph graph = Graph();
+  for(int i = 0; i < points.size(); i++)
+    for(int j = i + 1; j < points.size(); j++)
+      graph.add_edge(i, j, points.distance(i, j));
+  Prim prim = Prim(graph);
+  return prim.mst().edge_costs();
+}
+
+TEST(point_set_test_suite, test_add_point) {
+  PointSet points = PointSet();
+  points.add_point({ 0.0, 0.0 });
+  points.add_point({ 3.0, 4.0 });
+  EXPECT_EQ(2, points.size()) << "Point set size should be 2.";
+  EXPECT_EQ(2, points.dimension()) << "Point dimension should be 2.";
+  EXPECT_EQ(5.0, points.distance(0, 1)) << "Distance should be 5.";
+}
+
+TEST(euclidean_mst_test_suite, test_collinear_points) {
+  PointSet points = PointSet();
+  points.add_point({ 0.0 });
+  points.add_point({ 4.0 });
+  points.add_point({ 1.0 });
+  points.add_point({ 2.5 });
+  EuclideanMst emst = EuclideanMst(points);
+  Graph mst = emst.mst();
+  EXPECT_EQ(4.0, mst.edge_costs()) << "Min. cost should be 4.";
+  EXPECT_EQ(4, mst.size()) << "MST should span all 4 points.";
+  EXPECT_EQ(4.0, emst.mst().edge_costs())
+    << "A second call should compute the same MST.";
+}
+
+TEST(euclidean_mst_test_suite, test_grid_points) {
+  // Grid points have many equal distances.
+  PointSet points = PointSet();
+  for(int x = 0; x < 10; x++)
+    for(int y = 0; y < 10; y++)
+      points.add_point({ static_cast<double>(x), static_cast<double>(y) });
+  EuclideanMst emst = EuclideanMst(points);
+  Graph mst = emst.mst();
+  EXPECT_EQ(99.0, mst.edge_costs()) << "Min. cost should be 99.";
+  EXPECT_EQ(100, mst.size()) << "MST should span all 100 points.";
+}
+
+TEST(euclidean_mst_test_suite, test_match_prim_2d) {
+  for(unsigned seed = 1; seed <= 5; seed++) {
+    PointSet points = random_points(200, 2, seed);
+    EuclideanMst emst = EuclideanMst(points);
+    EXPECT_NEAR(complete_graph_mst_cost(points), emst.mst().edge_costs(),
+		TOLERANCE) << "Min. cost should match Prim for seed: " << seed;
+  }
+}
+
+TEST(euclidean_mst_test_suite, test_match_prim_3d) {
+  for(unsigned seed = 1; seed <= 5; seed++) {
+    PointSet points = random_points(200, 3, seed);
+    EuclideanMst emst = EuclideanMst(points);
+    EXPECT_NEAR(complete_graph_mst_cost(points), emst.mst().edge_costs(),
+		TOLERANCE) << "Min. cost should match Prim for seed: " << seed;
+  }
+}
@@ -0,0 +1,417 @@
+// Homework 2
+// Implement random graph generators and edge sinks.
+
+#include "graph_generators.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+const int GENERATOR_BATCH = 256;    // Uniforms generated per batch.
+const double PI = 3.14159265358979323846;
+
+// A batch of uniforms in [0, 1) from a Philox generator.  Uniforms are
+// generated a batch at a time, which is faster than one by one.
+class UniformBatch {
+ public:
+  // Construct the batch for the given generator.
+  UniformBatch(Philox& generator)
+    : generator_(generator), index_(GENERATOR_BATCH) {}
+  // Return random integer in [0, bound).
+  int64_t integer(int64_t bound) {
+    return min(static_cast<int64_t>(next() * bound), bound - 1);
+  }
+  // Return next uniform.
+  double next() {
+    if(index_ == GENERATOR_BATCH) {
+      generator_.fill_uniform(uniforms_, GENERATOR_BATCH);
+      index_ = 0;
+    }
+    return uniforms_[index_++];
+  }
+ private:
+  // Source of random numbers.
+  Philox& generator_;
+  // Index of next uniform.
+  int index_;
+  // Current batch.
+  double uniforms_[GENERATOR_BATCH];
+};
+
+// Return random distance in [min_distance, max_distance).
+static double random_distance(UniformBatch& uniforms, double min_distance,
+			      double max_distance) {
+  return min_distance + (max_distance - min_distance) * uniforms.next();
+}
+
+// ===================
+//  BinaryGraphWriter
+// ===================
+
+// Construct the writer and write the header with an edge count of 0.
+// If the file cannot be opened, the writes do nothing and ok() is false.
+BinaryGraphWriter::BinaryGraphWriter(const string& filename,
+				     uint64_t vertices)
+  : edges_(0), file_(filename, ios::binary) {
+  file_.write(reinterpret_cast<const char*>(&BINARY_GRAPH_MAGIC),
+	      sizeof(BINARY_GRAPH_MAGIC));
+  file_.write(reinterpret_cast<const char*>(&BINARY_GRAPH_VERSION),
+	      sizeof(BINARY_GRAPH_VERSION));
+  file_.write(reinterpret_cast<const char*>(&vertices), sizeof(vertices));
+  file_.write(reinterpret_cast<const char*>(&edges_), sizeof(edges_));
+}
+
+// Write edge to the file.
+void BinaryGraphWriter::add_edge(int vertex1, int vertex2, double distance) {
+  uint32_t vertices[2] = { static_cast<uint32_t>(vertex1),
+			   static_cast<uint32_t>(vertex2) };
+  file_.write(reinterpret_cast<const char*>(vertices), sizeof(vertices));
+  file_.write(reinterpret_cast<const char*>(&distance), sizeof(distance));
+  edges_++;
+}
+
+// Write the edge count into the header and close the file.
+void BinaryGraphWriter::close() {
+  if(!file_.is_open())
+    return;
+  file_.seekp(2 * sizeof(uint32_t) + sizeof(uint64_t));
+  file_.write(reinterpret_cast<const char*>(&edges_), sizeof(edges_));
+  file_.close();
+}
+
+// Read a binary graph file and push its edges into the sink.  Edges are
+// pushed as they are read, so a truncated file stops at its last whole
+// edge.
+bool read_binary_graph(const string& filename, EdgeSink& sink,
+		       uint64_t& vertices) {
+  ifstream file(filename, ios::binary);
+  uint32_t magic, version, edge_vertices[2];
+  uint64_t graph_vertices, edges;
+  double distance;
+
+  if(!file.is_open())
+    return false;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if(!file || magic != BINARY_GRAPH_MAGIC ||
+     version != BINARY_GRAPH_VERSION)
+    return false;
+  file.read(reinterpret_cast<char*>(&graph_vertices),
+	    sizeof(graph_vertices));
+  file.read(reinterpret_cast<char*>(&edges), sizeof(edges));
+  if(!file)
+    return false;
+  for(uint64_t i = 0; i < edges; i++) {
+    file.read(reinterpret_cast<char*>(edge_vertices),
+	      sizeof(edge_vertices));
+    file.read(reinterpret_cast<char*>(&distance), sizeof(distance));
+    if(!file)
+      return false;
+    sink.add_edge(edge_vertices[0], edge_vertices[1], distance);
+  }
+  vertices = graph_vertices;
+  return true;
+}
+
+// ================
+//  GraphGenerator
+// ================
+
+// Return the description.  Values are written with all significant
+// digits, so that equal descriptions mean equal parameters.
+string GraphGenerator::description() const {
+  ostringstream out;
+
+  out << setprecision(17) << name() << " vertices=" << vertices_
+      << " distance=[" << min_distance_ << ", " << max_distance_ << ")";
+  write_parameters(out);
+  return out.str();
+}
+
+// ==============
+//  GnpGenerator
+// ==============
+
+// Generate a random graph.  Vertex pairs (vertex1, vertex2) with
+// vertex1 < vertex2 are visited in row order, skipping the pairs without
+// edges.
+void GnpGenerator::generate(Philox& generator, EdgeSink& sink) const {
+  UniformBatch uniforms = UniformBatch(generator);
+  const double max_skip = static_cast<double>(vertices_) * vertices_;
+  double skip = 0.0;
+  int64_t vertex1 = 0, vertex2 = 0;
+
+  if(edge_density_ <= 0.0)
+    return;
+  while(vertex1 < vertices_ - 1) {
+
+    // Advance past the skipped pairs, wrapping to the following rows.
+    if(edge_density_ < 1.0)
+      skip = floor(log(1.0 - uniforms.next()) / log(1.0 - edge_density_));
+    vertex2 += 1 + static_cast<int64_t>(min(skip, max_skip));
+    while(vertex2 >= vertices_ && vertex1 < vertices_ - 1) {
+      vertex2 = vertex2 - vertices_ + vertex1 + 2;
+      vertex1++;
+    }
+    if(vertex1 >= vertices_ - 1)
+      break;
+    sink.add_edge(vertex1, vertex2,
+		  random_distance(uniforms, min_distance_, max_distance_));
+  }
+}
+
+// Write the model parameters.
+void GnpGenerator::write_parameters(ostream& out) const {
+  out << " edge_density=" << edge_density_;
+}
+
+// ==============
+//  GnmGenerator
+// ==============
+
+// Construct the generator.
+GnmGenerator::GnmGenerator(int vertices, int64_t edges, double min_distance,
+			   double max_distance)
+  : GraphGenerator(vertices, min_distance, max_distance),
+    edges_(edges) {
+  assert(0 <= edges &&
+	 edges <= static_cast<int64_t>(vertices) * (vertices - 1) / 2);
+}
+
+// Generate a random graph.  Pair index k stands for the pair
+// (vertex1, vertex2) with vertex1 < vertex2 and
+// k = vertex2 * (vertex2 - 1) / 2 + vertex1.
+void GnmGenerator::generate(Philox& generator, EdgeSink& sink) const {
+  UniformBatch uniforms = UniformBatch(generator);
+  int64_t pairs = static_cast<int64_t>(vertices_) * (vertices_ - 1) / 2;
+  int64_t pair, vertex1, vertex2;
+  unordered_set<int64_t> chosen;
+
+  // Floyd's algorithm: for each of the last m indices j, choose a random
+  // index up to j, or j itself if that index was chosen before.
+  chosen.reserve(edges_);
+  for(int64_t j = pairs - edges_; j < pairs; j++) {
+    pair = uniforms.integer(j + 1);
+    if(!chosen.insert(pair).second) {
+      pair = j;
+      chosen.insert(pair);
+    }
+
+    // Decode the pair index, correcting rounding of the square root.
+    vertex2 = (1.0 + sqrt(1.0 + 8.0 * pair)) / 2.0;
+    while(vertex2 * (vertex2 - 1) / 2 > pair)
+      vertex2--;
+    while((vertex2 + 1) * vertex2 / 2 <= pair)
+      vertex2++;
+    vertex1 = pair - vertex2 * (vertex2 - 1) / 2;
+    sink.add_edge(vertex1, vertex2,
+		  random_distance(uniforms, min_distance_, max_distance_));
+  }
+}
+
+// Write the model parameters.
+void GnmGenerator::write_parameters(ostream& out) const {
+  out << " edges=" << edges_;
+}
+
+// =========================
+//  BarabasiAlbertGenerator
+// =========================
+
+// Generate a random graph.  Endpoints of all edges are kept in a list,
+// so a uniform entry of the list is a vertex chosen with probability
+// proportional to its degree.  Edge k joins endpoints 2k and 2k + 1.
+void BarabasiAlbertGenerator::generate(Philox& generator,
+				       EdgeSink& sink) const {
+  UniformBatch uniforms = UniformBatch(generator);
+  vector<int> endpoints(2 * static_cast<size_t>(vertices_) *
+			edges_per_vertex_);
+  int64_t edge = 0;
+
+  for(int vertex = 0; vertex < vertices_; vertex++)
+    for(int i = 0; i < edges_per_vertex_; i++, edge++) {
+      endpoints[2 * edge] = vertex;
+      endpoints[2 * edge + 1] = endpoints[uniforms.integer(2 * edge + 1)];
+
+      // Attaching to itself is only possible while the graph is nearly
+      // empty.  Drop such self loops.
+      if(endpoints[2 * edge + 1] != vertex)
+	sink.add_edge(vertex, endpoints[2 * edge + 1],
+		      random_distance(uniforms, min_distance_,
+				      max_distance_));
+    }
+}
+
+// Write the model parameters.
+void BarabasiAlbertGenerator::write_parameters(ostream& out) const {
+  out << " edges_per_vertex=" << edges_per_vertex_;
+}
+
+// ====================
+//  GeometricGenerator
+// ====================
+
+// Draw the points of a graph.
+void GeometricGenerator::draw_points(Philox& generator,
+				     vector<double>& points) const {
+  points.resize(2 * static_cast<size_t>(vertices_));
+  generator.fill_uniform(points.data(), points.size());
+}
+
+// Generate a random graph.  Points are sorted into cells by counting, and
+// each point is compared with the later points of its own cell and with
+// the points of the four cells right or above it, so each pair is
+// compared at most once.
+void GeometricGenerator::generate(Philox& generator, EdgeSink& sink) const {
+  const int neighbor_cells[4][2] = {{ 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 }};
+  vector<double> points;
+  vector<int> cell_start, order;
+  double squared_radius = radius_ * radius_, dx, dy;
+  int cells, cell, x, y;
+
+  draw_points(generator, points);
+  UniformBatch uniforms = UniformBatch(generator);
+
+  // Cells per side, with sides of at least the radius.  Also bound the
+  // cell count by the number of points for small radii.
+  cells = 1;
+  if(radius_ > 0.0)
+    cells = max(1.0, min(floor(1.0 / radius_),
+			 ceil(sqrt(static_cast<double>(vertices_)))));
+  auto cell_of = [&](int point, int& cx, int& cy) {
+    cx = min(cells - 1, static_cast<int>(points[2 * point] * cells));
+    cy = min(cells - 1, static_cast<int>(points[2 * point + 1] * cells));
+  };
+
+  // Counting sort of points by cell.
+  cell_start.assign(cells * cells + 1, 0);
+  for(int point = 0; point < vertices_; point++) {
+    cell_of(point, x, y);
+    cell_start[y * cells + x + 1]++;
+  }
+  for(int i = 0; i < cells * cells; i++)
+    cell_start[i + 1] += cell_start[i];
+  order.resize(vertices_);
+  vector<int> next = cell_start;
+  for(int point = 0; point < vertices_; point++) {
+    cell_of(point, x, y);
+    order[next[y * cells + x]++] = point;
+  }
+
+  // Compare points of nearby cells.
+  auto connect = [&](int point1, int point2) {
+    dx = points[2 * point1] - points[2 * point2];
+    dy = points[2 * point1 + 1] - points[2 * point2 + 1];
+    if(dx * dx + dy * dy <= squared_radius)
+      sink.add_edge(point1, point2,
+		    random_distance(uniforms, min_distance_, max_distance_));
+  };
+  for(y = 0; y < cells; y++)
+    for(x = 0; x < cells; x++) {
+      cell = y * cells + x;
+      for(int i = cell_start[cell]; i < cell_start[cell + 1]; i++) {
+	for(int j = i + 1; j < cell_start[cell + 1]; j++)
+	  connect(order[i], order[j]);
+	for(auto& offset: neighbor_cells) {
+	  int nx = x + offset[0], ny = y + offset[1];
+	  if(nx < 0 || nx >= cells || ny < 0 || ny >= cells)
+	    continue;
+	  int neighbor = ny * cells + nx;
+	  for(int j = cell_start[neighbor]; j < cell_start[neighbor + 1]; j++)
+	    connect(order[i], order[j]);
+	}
+      }
+    }
+}
+
+// Write the model parameters.
+void GeometricGenerator::write_parameters(ostream& out) const {
+  out << " radius=" << radius_;
+}
+
+// ===============
+//  RmatGenerator
+// ===============
+
+// Construct the generator.
+RmatGenerator::RmatGenerator(int vertices, int64_t edges,
+			     double min_distance, double max_distance,
+			     double a, double b, double c)
+  : GraphGenerator(vertices, min_distance, max_distance),
+    a_(a), b_(b), c_(c),
+    edges_(edges),
+    levels_(0) {
+  assert(vertices >= 2);
+  assert(a >= 0.0 && b >= 0.0 && c >= 0.0 && a + b + c <= 1.0);
+  while((1LL << levels_) < vertices)
+    levels_++;
+}
+
+// Generate a random graph.
+void RmatGenerator::generate(Philox& generator, EdgeSink& sink) const {
+  UniformBatch uniforms = UniformBatch(generator);
+  int64_t row, column;
+  double u;
+
+  for(int64_t edge = 0; edge < edges_; edge++) {
+    do {
+      row = column = 0;
+      for(int level = 0; level < levels_; level++) {
+	u = uniforms.next();
+	row = 2 * row + (u >= a_ + b_);
+	column = 2 * column + ((u >= a_ && u < a_ + b_) || u >= a_ + b_ + c_);
+      }
+    } while(row >= vertices_ || column >= vertices_ || row == column);
+    sink.add_edge(row, column,
+		  random_distance(uniforms, min_distance_, max_distance_));
+  }
+}
+
+// Write the model parameters.
+void RmatGenerator::write_parameters(ostream& out) const {
+  out << " edges=" << edges_ << " a=" << a_ << " b=" << b_ << " c=" << c_;
+}
+
+// Return generator of the given name.  Return an empty pointer for an
+// unknown name.
+unique_ptr<GraphGenerator> make_generator(const string& name, int vertices,
+					  double edge_density,
+					  double min_distance,
+					  double max_distance) {
+  double pairs = static_cast<double>(vertices) * (vertices - 1) / 2;
+  int64_t edges = llround(edge_density * pairs);
+
+  if(name == "gnp")
+    return unique_ptr<GraphGenerator>(
+      new GnpGenerator(vertices, edge_density, min_distance, max_distance));
+  if(name == "gnm")
+    return unique_ptr<GraphGenerator>(
+      new GnmGenerator(vertices, edges, min_distance, max_distance));
+
+  // Each vertex attaches about half of the mean degree.
+  if(name == "ba")
+    return unique_ptr<GraphGenerator>(
+      new BarabasiAlbertGenerator(vertices,
+				  max(1L, lround(edge_density *
+						 (vertices - 1) / 2)),
+				  min_distance, max_distance));
+
+  // A point connects to an area of about pi * radius^2.
+  if(name == "geometric")
+    return unique_ptr<GraphGenerator>(
+      new GeometricGenerator(vertices, sqrt(edge_density / PI),
+			     min_distance, max_distance));
+  if(name == "rmat")
+    return unique_ptr<GraphGenerator>(
+      new RmatGenerator(vertices, edges, min_distance, max_distance));
+  return unique_ptr<GraphGenerator>();
+}
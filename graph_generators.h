@@ -0,0 +1,246 @@
+// Header file for random graph generators and edge sinks.
+
+#ifndef GRAPH_GENERATORS_H_
+#define GRAPH_GENERATORS_H_
+
+#include "dijkstra.h"
+#include "philox.h"
+
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Magic number at the start of binary graph files ("RGRF").
+const uint32_t BINARY_GRAPH_MAGIC = 0x46524752;
+const uint32_t BINARY_GRAPH_VERSION = 1;   // Binary graph format version.
+
+// Receiver of generated edges.  Generators push edges into a sink as
+// they go, so that no intermediate edge list is needed.
+class EdgeSink {
+ public:
+  virtual ~EdgeSink() {}
+  // Add undirected edge between two vertices.
+  virtual void add_edge(int vertex1, int vertex2, double distance) = 0;
+};
+
+// Sink that adds edges to an AdjacencyGraph.  Vertex numbers are shifted
+// by the given offset, e.g. INIT_VERTEX for graphs numbered from 1.
+class AdjacencyGraphSink : public EdgeSink {
+ public:
+  // Construct the sink for the given graph and vertex offset.
+  AdjacencyGraphSink(AdjacencyGraph& graph, int offset=0)
+    : graph_(graph), offset_(offset) {}
+  // Add edge to the graph.
+  void add_edge(int vertex1, int vertex2, double distance) {
+    graph_.add_edge(vertex1 + offset_, vertex2 + offset_, distance);
+  }
+ private:
+  // Graph receiving the edges.
+  AdjacencyGraph& graph_;
+  // Offset added to vertex numbers.
+  int offset_;
+};
+
+// Sink that writes edges to a binary graph file.  The format, in the
+// byte order of the host, is:
+// - header: uint32 magic, uint32 version, uint64 vertices, uint64 edges.
+// - edges: uint32 vertex1, uint32 vertex2, double distance per edge.
+// The edge count is not known while streaming, so close() writes it
+// into the header at the end.  Failures to open or write the file are
+// reported by ok() rather than by each call.
+class BinaryGraphWriter : public EdgeSink {
+ public:
+  // Construct the writer for a graph with the given number of vertices.
+  BinaryGraphWriter(const string& filename, uint64_t vertices);
+  // Close the file if not closed yet.
+  ~BinaryGraphWriter() { close(); }
+  // Write edge to the file.
+  void add_edge(int vertex1, int vertex2, double distance);
+  // Write the edge count and close the file.
+  void close();
+  // Return the number of edges written.
+  uint64_t edges() const { return edges_; }
+  // Return whether the file was opened and every write so far
+  // succeeded.  Check after close() for the whole file.
+  bool ok() const { return !file_.fail(); }
+ private:
+  // Number of edges written.
+  uint64_t edges_;
+  // Output file.
+  ofstream file_;
+};
+
+// Read a binary graph file, push its edges into the sink and store its
+// number of vertices in vertices.  Return false if the file cannot be
+// opened, is not a binary graph of this version or is truncated, in
+// which case the sink may have received some of the edges.
+bool read_binary_graph(const string& filename, EdgeSink& sink,
+		       uint64_t& vertices);
+
+// Abstract random graph generator.  generate() draws all random numbers
+// from the given generator, so a graph is reproducible from the Philox
+// seed and stream, and generators hold no state between graphs, so
+// threads may share them.  Vertices are numbered from 0, and edge
+// distances are uniform in [min_distance, max_distance).
+class GraphGenerator {
+ public:
+  // Construct the generator for the given vertices and distances.
+  GraphGenerator(int vertices, double min_distance, double max_distance)
+    : max_distance_(max_distance),
+      min_distance_(min_distance),
+      vertices_(vertices) {}
+  virtual ~GraphGenerator() {}
+  // Return the name, the number of vertices, the distances and the model
+  // parameters, so that checkpoints can tell generators apart.
+  string description() const;
+  // Generate a random graph and push its edges into the sink.
+  virtual void generate(Philox& generator, EdgeSink& sink) const = 0;
+  // Return the name of the generator, as given to make_generator().
+  virtual string name() const = 0;
+  // Return the number of vertices.
+  int vertices() const { return vertices_; }
+ protected:
+  // Write the model parameters for description().
+  virtual void write_parameters(ostream& out) const = 0;
+  // Maximum distance.
+  double max_distance_;
+  // Minimum distance.
+  double min_distance_;
+  // Number of vertices.
+  int vertices_;
+};
+
+// G(n, p) generator: each vertex pair has an edge with the given
+// probability.  Like RandomGraph, it draws the geometrically distributed
+// gaps between edges, so the cost is O(n + m).
+class GnpGenerator : public GraphGenerator {
+ public:
+  // Construct the generator for the given edge density.
+  GnpGenerator(int vertices, double edge_density, double min_distance,
+	       double max_distance)
+    : GraphGenerator(vertices, min_distance, max_distance),
+      edge_density_(edge_density) {}
+  // Generate a random graph.
+  void generate(Philox& generator, EdgeSink& sink) const;
+  // Return the name of the generator.
+  string name() const { return "gnp"; }
+ private:
+  // Write the model parameters.
+  void write_parameters(ostream& out) const;
+  // Edge density.
+  double edge_density_;
+};
+
+// G(n, m) generator: exactly m distinct vertex pairs, chosen uniformly.
+// Pairs are drawn by Floyd's sampling algorithm over pair indices, so the
+// cost is O(m) expected time and memory.
+class GnmGenerator : public GraphGenerator {
+ public:
+  // Construct the generator for the given number of edges.
+  GnmGenerator(int vertices, int64_t edges, double min_distance,
+	       double max_distance);
+  // Generate a random graph.
+  void generate(Philox& generator, EdgeSink& sink) const;
+  // Return the name of the generator.
+  string name() const { return "gnm"; }
+ private:
+  // Write the model parameters.
+  void write_parameters(ostream& out) const;
+  // Number of edges.
+  int64_t edges_;
+};
+
+// Barabasi-Albert preferential attachment generator.  Each new vertex
+// attaches edges to existing vertices with probabilities proportional to
+// their degrees, which gives a power-law degree distribution.  The
+// endpoint list algorithm of Batagelj & Brandes (2005) runs in O(n + m).
+// As in that algorithm, a vertex may attach twice to the same target;
+// such parallel edges are kept.
+class BarabasiAlbertGenerator : public GraphGenerator {
+ public:
+  // Construct the generator where each vertex attaches the given number
+  // of edges.
+  BarabasiAlbertGenerator(int vertices, int edges_per_vertex,
+			  double min_distance, double max_distance)
+    : GraphGenerator(vertices, min_distance, max_distance),
+      edges_per_vertex_(edges_per_vertex) {}
+  // Generate a random graph.
+  void generate(Philox& generator, EdgeSink& sink) const;
+  // Return the name of the generator.
+  string name() const { return "ba"; }
+ private:
+  // Write the model parameters.
+  void write_parameters(ostream& out) const;
+  // Edges attached by each new vertex.
+  int edges_per_vertex_;
+};
+
+// Random geometric graph generator: vertices are uniform points in the
+// unit square, and points within the given radius are connected.  Points
+// are bucketed into a grid of cells with sides of at least the radius,
+// so only neighboring cells are compared, and the cost is O(n + m)
+// expected.
+class GeometricGenerator : public GraphGenerator {
+ public:
+  // Construct the generator for the given connection radius.
+  GeometricGenerator(int vertices, double radius, double min_distance,
+		     double max_distance)
+    : GraphGenerator(vertices, min_distance, max_distance),
+      radius_(radius) {}
+  // Draw the points of a graph.  Coordinates are stored point by point.
+  // generate() draws the points first with this method.
+  void draw_points(Philox& generator, vector<double>& points) const;
+  // Generate a random graph.
+  void generate(Philox& generator, EdgeSink& sink) const;
+  // Return the name of the generator.
+  string name() const { return "geometric"; }
+ private:
+  // Write the model parameters.
+  void write_parameters(ostream& out) const;
+  // Connection radius.
+  double radius_;
+};
+
+// R-MAT generator (Chakrabarti et al., R-MAT: a recursive model for
+// graph mining, SDM 2004).  Each edge descends the quadrants of the
+// adjacency matrix of the next power of two vertices, with probabilities
+// a, b, c and 1 - a - b - c, which gives skewed, community-like degree
+// distributions.  Edges with an endpoint beyond the number of vertices
+// and self loops are redrawn, while duplicate edges are kept.  The cost
+// is O(m log n).
+class RmatGenerator : public GraphGenerator {
+ public:
+  // Construct the generator for the given edges and quadrant
+  // probabilities.
+  RmatGenerator(int vertices, int64_t edges, double min_distance,
+		double max_distance, double a=0.57, double b=0.19,
+		double c=0.19);
+  // Generate a random graph.
+  void generate(Philox& generator, EdgeSink& sink) const;
+  // Return the name of the generator.
+  string name() const { return "rmat"; }
+ private:
+  // Write the model parameters.
+  void write_parameters(ostream& out) const;
+  // Quadrant probabilities.
+  double a_, b_, c_;
+  // Number of edges.
+  int64_t edges_;
+  // Levels of quadrants, i.e. log2 of the matrix size.
+  int levels_;
+};
+
+// Return generator of the given name: gnp, gnm, ba, geometric or rmat.
+// The edge density sets the parameter of each model so that the
+// expected number of edges is close to that of G(n, p).
+unique_ptr<GraphGenerator> make_generator(const string& name, int vertices,
+					  double edge_density,
+					  double min_distance,
+					  double max_distance);
+
+#endif // GRAPH_GENERATORS_H_
@@ -0,0 +1,268 @@
+// Unit tests for random graph generators using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "graph_generators.h"
+#include "random_graph.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+const double MAX_DISTANCE = 10.0;
+const double MIN_DISTANCE = 1.0;
+
+// Sink that keeps all edges.
+class EdgeListSink : public EdgeSink {
+ public:
+  // Keep the edge.
+  void add_edge(int vertex1, int vertex2, double distance) {
+    edges.push_back(Edge{ vertex1, vertex2, distance });
+  }
+  // Return the degree of each vertex.
+  vector<int> degrees(int vertices) const {
+    vector<int> result(vertices, 0);
+    for(auto& edge: edges) {
+      result[edge.vertex1]++;
+      result[edge.vertex2]++;
+    }
+    return result;
+  }
+  // Edge with its endpoints and distance.
+  struct Edge {
+    int vertex1, vertex2;
+    double distance;
+  };
+  // Edges in order of generation.
+  vector<Edge> edges;
+};
+
+// Generate a graph from the given seed and return its edges.
+static EdgeListSink generate(const GraphGenerator& generator, int seed) {
+  Philox philox = Philox(seed);
+  EdgeListSink sink;
+  generator.generate(philox, sink);
+  return sink;
+}
+
+// Check that the edges are valid and reproducible.
+static void check_edges(const GraphGenerator& generator) {
+  EdgeListSink sink1 = generate(generator, 7), sink2 = generate(generator, 7);
+  ASSERT_EQ(sink1.edges.size(), sink2.edges.size())
+    << "Graphs from the same seed should have the same edges.";
+  for(size_t i = 0; i < sink1.edges.size(); i++) {
+    auto& edge = sink1.edges[i];
+    EXPECT_TRUE(0 <= edge.vertex1 && edge.vertex1 < generator.vertices() &&
+		0 <= edge.vertex2 && edge.vertex2 < generator.vertices())
+      << "Vertex is out of range in edge: " << i;
+    EXPECT_NE(edge.vertex1, edge.vertex2) << "Self loop in edge: " << i;
+    EXPECT_TRUE(MIN_DISTANCE <= edge.distance &&
+		edge.distance < MAX_DISTANCE)
+      << "Distance is out of range in edge: " << i;
+    EXPECT_EQ(edge.distance, sink2.edges[i].distance)
+      << "Distance should be reproducible in edge: " << i;
+  }
+}
+
+TEST(graph_generators_test_suite, test_gnp) {
+  const int vertices = 2000;
+  GnpGenerator generator = GnpGenerator(vertices, 0.01, MIN_DISTANCE,
+					MAX_DISTANCE);
+  check_edges(generator);
+  double pairs = vertices * (vertices - 1) / 2.0;
+  EXPECT_NEAR(0.01 * pairs, generate(generator, 3).edges.size(),
+	      0.02 * 0.01 * pairs) << "Edge count is off.";
+  GnpGenerator complete = GnpGenerator(30, 1.0, MIN_DISTANCE, MAX_DISTANCE);
+  EXPECT_EQ(30 * 29 / 2, generate(complete, 3).edges.size())
+    << "Complete graph should have all edges.";
+}
+
+TEST(graph_generators_test_suite, test_gnp_matches_random_graph) {
+  // Both draw skips and distances from the same stream in the same order.
+  GnpGenerator generator = GnpGenerator(MAX_VERTICES, 0.3, MIN_DISTANCE,
+					MAX_DISTANCE);
+  for(int stream = 0; stream < 5; stream++) {
+    TrialContext context = TrialContext();
+    RandomGraph rgraph = RandomGraph(0.3, MIN_DISTANCE, MAX_DISTANCE, 9,
+				     stream, context);
+    Philox philox = Philox(9, stream);
+    EdgeListSink sink;
+    generator.generate(philox, sink);
+    EXPECT_EQ(rgraph.edges(), sink.edges.size())
+      << "Edge count should match for stream: " << stream;
+  }
+}
+
+TEST(graph_generators_test_suite, test_gnm) {
+  const int vertices = 300;
+  for(int64_t edges: { 0L, 1L, 5000L, 44850L }) {
+    GnmGenerator generator = GnmGenerator(vertices, edges, MIN_DISTANCE,
+					  MAX_DISTANCE);
+    check_edges(generator);
+    EdgeListSink sink = generate(generator, 5);
+    set<pair<int, int> > pairs;
+    for(auto& edge: sink.edges)
+      pairs.insert(make_pair(min(edge.vertex1, edge.vertex2),
+			     max(edge.vertex1, edge.vertex2)));
+    EXPECT_EQ(edges, sink.edges.size()) << "Edge count is wrong.";
+    EXPECT_EQ(edges, pairs.size()) << "Edges should be distinct.";
+  }
+}
+
+TEST(graph_generators_test_suite, test_barabasi_albert) {
+  const int vertices = 20000;
+  BarabasiAlbertGenerator generator =
+    BarabasiAlbertGenerator(vertices, 3, MIN_DISTANCE, MAX_DISTANCE);
+  check_edges(generator);
+  EdgeListSink sink = generate(generator, 5);
+  EXPECT_NEAR(3 * vertices, sink.edges.size(), 0.01 * vertices)
+    << "Each vertex should attach 3 edges, except for self loops.";
+
+  // Preferential attachment gives hubs far above the mean degree of 6.
+  vector<int> degrees = sink.degrees(vertices);
+  EXPECT_GT(*max_element(degrees.begin(), degrees.end()), 100)
+    << "Degree distribution should be heavy-tailed.";
+}
+
+TEST(graph_generators_test_suite, test_geometric) {
+  const int vertices = 3000;
+  const double radius = 0.03;
+  GeometricGenerator generator = GeometricGenerator(vertices, radius,
+						    MIN_DISTANCE,
+						    MAX_DISTANCE);
+  check_edges(generator);
+
+  // Compare with all pairs of the same points.
+  Philox philox = Philox(5);
+  vector<double> points;
+  generator.draw_points(philox, points);
+  set<pair<int, int> > expect, pairs;
+  for(int i = 0; i < vertices; i++)
+    for(int j = i + 1; j < vertices; j++) {
+      double dx = points[2 * i] - points[2 * j];
+      double dy = points[2 * i + 1] - points[2 * j + 1];
+      if(dx * dx + dy * dy <= radius * radius)
+	expect.insert(make_pair(i, j));
+    }
+  EdgeListSink sink = generate(generator, 5);
+  for(auto& edge: sink.edges)
+    pairs.insert(make_pair(min(edge.vertex1, edge.vertex2),
+			   max(edge.vertex1, edge.vertex2)));
+  EXPECT_EQ(expect.size(), sink.edges.size()) << "Edge count is wrong.";
+  EXPECT_TRUE(expect == pairs) << "Edges should match all-pairs search.";
+}
+
+TEST(graph_generators_test_suite, test_rmat) {
+  const int vertices = 1000;
+  RmatGenerator generator = RmatGenerator(vertices, 20000, MIN_DISTANCE,
+					  MAX_DISTANCE);
+  check_edges(generator);
+  EdgeListSink sink = generate(generator, 5);
+  EXPECT_EQ(20000, sink.edges.size()) << "Edge count is wrong.";
+
+  // Quadrant a favors low vertex numbers.
+  vector<int> degrees = sink.degrees(vertices);
+  int low = 0, high = 0;
+  for(int vertex = 0; vertex < vertices / 2; vertex++) {
+    low += degrees[vertex];
+    high += degrees[vertices - 1 - vertex];
+  }
+  EXPECT_GT(low, 2 * high) << "Degrees should be skewed.";
+}
+
+TEST(graph_generators_test_suite, test_binary_graph) {
+  const char* filename = "graph_generators_test.bin";
+  GnpGenerator generator = GnpGenerator(500, 0.05, MIN_DISTANCE,
+					MAX_DISTANCE);
+  EdgeListSink expect = generate(generator, 5), sink;
+  {
+    BinaryGraphWriter writer(filename, generator.vertices());
+    Philox philox = Philox(5);
+    generator.generate(philox, writer);
+    EXPECT_EQ(expect.edges.size(), writer.edges())
+      << "Writer should count all edges.";
+    writer.close();
+    EXPECT_TRUE(writer.ok()) << "File should be written.";
+  }
+  uint64_t vertices = 0;
+  ASSERT_TRUE(read_binary_graph(filename, sink, vertices))
+    << "Graph should be read.";
+  EXPECT_EQ(500, vertices) << "Vertex count is wrong.";
+  ASSERT_EQ(expect.edges.size(), sink.edges.size())
+    << "Edge count is wrong.";
+  for(size_t i = 0; i < sink.edges.size(); i++)
+    EXPECT_TRUE(expect.edges[i].vertex1 == sink.edges[i].vertex1 &&
+		expect.edges[i].vertex2 == sink.edges[i].vertex2 &&
+		expect.edges[i].distance == sink.edges[i].distance)
+      << "Edge is wrong: " << i;
+
+  // Truncated and foreign files are refused.
+  ifstream in(filename, ios::binary);
+  string bytes = string(istreambuf_iterator<char>(in),
+			istreambuf_iterator<char>());
+  in.close();
+  for(size_t size: { size_t(3), size_t(20), bytes.size() - 1 }) {
+    EdgeListSink truncated;
+    ofstream(filename, ios::binary).write(bytes.data(), size);
+    EXPECT_FALSE(read_binary_graph(filename, truncated, vertices))
+      << "Truncated file should be refused: " << size;
+  }
+  bytes[0] ^= 1;
+  ofstream(filename, ios::binary) << bytes;
+  EXPECT_FALSE(read_binary_graph(filename, sink, vertices))
+    << "Wrong magic should be refused.";
+  remove(filename);
+  EXPECT_FALSE(read_binary_graph(filename, sink, vertices))
+    << "Missing file should be refused.";
+
+  // A file that cannot be opened is reported without aborting.
+  BinaryGraphWriter unwritable("no_such_directory/graph.bin", 10);
+  unwritable.add_edge(0, 1, MIN_DISTANCE);
+  unwritable.close();
+  EXPECT_FALSE(unwritable.ok()) << "Unwritable file should be reported.";
+}
+
+TEST(graph_generators_test_suite, test_description) {
+  BarabasiAlbertGenerator ba = BarabasiAlbertGenerator(50, 2, 1.0, 10.0);
+  EXPECT_EQ("ba vertices=50 distance=[1, 10) edges_per_vertex=2",
+	    ba.description()) << "Description is wrong.";
+  for(string name: { "gnp", "gnm", "ba", "geometric", "rmat" }) {
+    unique_ptr<GraphGenerator> generator =
+      make_generator(name, MAX_VERTICES, 0.2, MIN_DISTANCE, MAX_DISTANCE);
+    EXPECT_EQ(name, generator->name()) << "Name is wrong: " << name;
+    EXPECT_EQ(size_t(0), generator->description().find(name + " vertices="))
+      << "Description should start with the name: " << name;
+  }
+}
+
+TEST(graph_generators_test_suite, test_simulation) {
+  EXPECT_FALSE(make_generator("unknown", MAX_VERTICES, 0.2, MIN_DISTANCE,
+			      MAX_DISTANCE)) << "Name should be unknown.";
+
+  // G(n, p) through the generator should reproduce RandomGraph trials.
+  unique_ptr<GraphGenerator> gnp = make_generator("gnp", MAX_VERTICES, 0.2,
+						  MIN_DISTANCE, MAX_DISTANCE);
+  Simulation sim1 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  Simulation sim2 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  sim2.set_generator(gnp.get());
+  sim1.run();
+  sim2.run();
+  EXPECT_EQ(sim1.average(), sim2.average())
+    << "G(n, p) generator should match RandomGraph.";
+
+  // Hubs of preferential attachment shorten paths.
+  unique_ptr<GraphGenerator> ba = make_generator("ba", MAX_VERTICES, 0.2,
+						 MIN_DISTANCE, MAX_DISTANCE);
+  Simulation sim3 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  sim3.set_generator(ba.get());
+  sim3.run();
+  EXPECT_LT(sim3.average(), sim1.average())
+    << "Barabasi-Albert paths should be shorter.";
+}
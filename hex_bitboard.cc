@@ -0,0 +1,352 @@
+// Implement bitboard representation of the hex board.
+
+#include "hex_bitboard.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <vector>
+
+using namespace std;
+
+// Round the given number up to a multiple of the given unit.
+static uint32_t round_up(uint32_t number, uint32_t unit) {
+  return (number + unit - 1) / unit * unit;
+}
+
+// ==================
+//  BitboardHexBoard
+// ==================
+
+// Construct a hex board and its masks.
+BitboardHexBoard::BitboardHexBoard(uint32_t size)
+  : flood_guard_(round_up((size + WORD_BITS - 1) / WORD_BITS + 1,
+			  FLOOD_VECTOR_WIDTH)),
+    moves_(0),
+    placed_(false),
+    positions_occupied_(0),
+    row_words_((size + WORD_BITS - 1) / WORD_BITS),
+    size_(size),
+    total_positions_(size * size),
+    winner_(Player::NONE) {
+  vector<BitboardWord> empty(size * row_words_, 0);
+
+  for(int player = 0; player < 2; player++) {
+    bitboards_[player] = empty;
+    for(int border = 0; border < 2; border++)
+      borders_[player][border] = connected_[player][border] = empty;
+  }
+  not_east_ = not_west_ = occupied_ = valid_ = empty;
+  search_stack_.reserve(total_positions_);
+  flood_.assign(2 * flood_guard_ + round_up(empty.size(), FLOOD_VECTOR_WIDTH),
+		0);
+  flood_next_ = flood_stones_ = flood_east_ = flood_west_ = flood_;
+  for(Row row = 0; row < size_; row++)
+    for(Column column = 0; column < size_; column++) {
+      set(valid_, row, column);
+      if(column != size_ - 1)
+	set(not_east_, row, column);
+      if(column != 0)
+	set(not_west_, row, column);
+      if(row == 0)
+	set(borders_[static_cast<int>(Player::COMPUTER)][0], row, column);
+      if(row == size_ - 1)
+	set(borders_[static_cast<int>(Player::COMPUTER)][1], row, column);
+      if(column == 0)
+	set(borders_[static_cast<int>(Player::CONTESTANT)][0], row, column);
+      if(column == size_ - 1)
+	set(borders_[static_cast<int>(Player::CONTESTANT)][1], row, column);
+    }
+  flood_not_east_ = flood_not_west_ = flood_;
+  copy(not_east_.begin(), not_east_.end(),
+       flood_not_east_.begin() + flood_guard_);
+  copy(not_west_.begin(), not_west_.end(),
+       flood_not_west_.begin() + flood_guard_);
+}
+
+// Add and validate a player to a given position on the hex board.
+Result BitboardHexBoard::add_player_position(Player player,
+					     Row row,
+					     Column column) {
+
+  // Do nothing if game is over.
+  assert(!placed_);
+  if(game_over())
+    return { false, GAME_OVER };
+
+  // Validate position.
+  if(row >= size_ || column >= size_)
+    return { false, INVALID_POSITION };
+  if(test(occupied_, row, column))
+    return { false, OCCUPIED_POSITION };
+
+  // Add player to the position and check if it wins.
+  assert(player != Player::NONE);
+  set(bitboards_[static_cast<int>(player)], row, column);
+  set(occupied_, row, column);
+  positions_occupied_++;
+  moves_++;
+
+  // Check if the stone wins, or else connect its group to the border it
+  // touches, if any.
+  bool touches0 = touches(player, 0, row, column);
+  bool touches1 = touches(player, 1, row, column);
+  if(touches0 && touches1)
+    winner_ = player;
+  else if(touches0)
+    connect_group(player, 0, row, column);
+  else if(touches1)
+    connect_group(player, 1, row, column);
+  return SUCCESS_RESULT;
+}
+
+// Add the group of the given stone to the stones connected to the
+// border.  The search stops at stones connected already, whose groups
+// are connected as a whole.
+void BitboardHexBoard::connect_group(Player player, int border, Row row,
+				     Column column) {
+  const vector<BitboardWord>& stones = bitboards_[static_cast<int>(player)];
+  vector<BitboardWord>& connected =
+    connected_[static_cast<int>(player)][border];
+  long neighbor_row, neighbor_column;
+
+  set(connected, row, column);
+  search_stack_.push_back(Position(row, column, size_));
+  while(!search_stack_.empty()) {
+    Position position = search_stack_.back();
+    search_stack_.pop_back();
+    for(auto& delta: NEIGHBOR_DELTAS) {
+      neighbor_row = position.row() + delta.row;
+      neighbor_column = position.column() + delta.column;
+      if(neighbor_row < 0 || neighbor_row >= size_ ||
+	 neighbor_column < 0 || neighbor_column >= size_ ||
+	 !test(stones, neighbor_row, neighbor_column) ||
+	 test(connected, neighbor_row, neighbor_column))
+	continue;
+      set(connected, neighbor_row, neighbor_column);
+      search_stack_.push_back(Position(neighbor_row, neighbor_column,
+				       size_));
+    }
+  }
+}
+
+// Check if the stones of the player connect its two borders.  The flood
+// starts from the stones on the first border.
+bool BitboardHexBoard::connects(Player player, FloodMethod method) const {
+  const int pl = static_cast<int>(player);
+
+  for(uint32_t i = 0; i < occupied_.size(); i++) {
+    flood_stones_[flood_guard_ + i] = bitboards_[pl][i];
+    flood_[flood_guard_ + i] = bitboards_[pl][i] & borders_[pl][0][i];
+  }
+  if(method == FloodMethod::SIMD)
+    return flood_simd(borders_[pl][1]);
+  return flood_word(borders_[pl][1]);
+}
+
+// Grow the flood by passes of vector operations.  With the flood masked
+// by not_east_ and not_west_ as east and west, a word of the next pass
+// is the union of
+// - the word, its east shifted up, and its west shifted down, with the
+//   bits carried in from the neighboring words: the same row;
+// - the same for the word a row below, for its eastern part only: the
+//   neighbors (row - 1, column) and (row - 1, column + 1) of that row;
+// - the same for the word a row above, for its western part only,
+// masked by the stones.  The buffers of east and west are filled for
+// all words first, so that every word loads them at any offset.
+bool BitboardHexBoard::flood_simd(const vector<BitboardWord>& target) const {
+  const int shift = WORD_BITS - 1;
+  const uint32_t end = flood_.size() - flood_guard_;
+  const int rows = row_words_;
+  auto load = [](const vector<BitboardWord>& buffer, uint32_t i) {
+    return *reinterpret_cast<const FloodVector*>(&buffer[i]);
+  };
+
+  while(!flood_reached(target)) {
+    FloodVector grown = FloodVector{};
+    for(uint32_t i = 0; i < flood_.size(); i += FLOOD_VECTOR_WIDTH) {
+      FloodVector flood = load(flood_, i);
+      *reinterpret_cast<FloodVector*>(&flood_east_[i]) =
+	flood & load(flood_not_east_, i);
+      *reinterpret_cast<FloodVector*>(&flood_west_[i]) =
+	flood & load(flood_not_west_, i);
+    }
+    for(uint32_t i = flood_guard_; i < end; i += FLOOD_VECTOR_WIDTH) {
+      FloodVector flood = load(flood_, i);
+      FloodVector next = flood |
+	load(flood_east_, i) << 1 | load(flood_east_, i - 1) >> shift |
+	load(flood_west_, i) >> 1 | load(flood_west_, i + 1) << shift |
+	load(flood_, i + rows) | load(flood_east_, i + rows) << 1 |
+	load(flood_east_, i + rows - 1) >> shift |
+	load(flood_, i - rows) | load(flood_west_, i - rows) >> 1 |
+	load(flood_west_, i - rows + 1) << shift;
+      next &= load(flood_stones_, i);
+      grown |= next ^ flood;
+      *reinterpret_cast<FloodVector*>(&flood_next_[i]) = next;
+    }
+    flood_.swap(flood_next_);
+    bool stopped = true;
+    for(int lane = 0; lane < FLOOD_VECTOR_WIDTH; lane++)
+      stopped &= grown[lane] == 0;
+    if(stopped)
+      return false;
+  }
+  return true;
+}
+
+// Grow the flood in place, in sweeps down and up.  Each word is updated
+// as in flood_simd() from the current words around it, then grown
+// within itself until its runs of stones are filled.
+bool BitboardHexBoard::flood_word(const vector<BitboardWord>& target) const {
+  const int shift = WORD_BITS - 1;
+  const int rows = row_words_, words = occupied_.size();
+  BitboardWord* flood = &flood_[flood_guard_];
+  const BitboardWord* stones = &flood_stones_[flood_guard_];
+  const BitboardWord* not_east = &flood_not_east_[flood_guard_];
+  const BitboardWord* not_west = &flood_not_west_[flood_guard_];
+  auto east = [&](int i) {
+    return flood[i] | (flood[i] & not_east[i]) << 1 |
+      (flood[i - 1] & not_east[i - 1]) >> shift;
+  };
+  auto west = [&](int i) {
+    return flood[i] | (flood[i] & not_west[i]) >> 1 |
+      (flood[i + 1] & not_west[i + 1]) << shift;
+  };
+  auto update = [&](int i) {
+    BitboardWord next = (east(i) | west(i) | east(i + rows) |
+			 west(i - rows)) & stones[i];
+    BitboardWord word = flood[i];
+    while(next != word) {
+      word = next;
+      next = (word | (word & not_east[i]) << 1 |
+	      (word & not_west[i]) >> 1) & stones[i];
+    }
+    bool grown = word != flood[i];
+    flood[i] = word;
+    return grown;
+  };
+
+  while(!flood_reached(target)) {
+    bool grown = false;
+    for(int i = 0; i < words; i++)
+      grown |= update(i);
+    for(int i = words - 1; i >= 0; i--)
+      grown |= update(i);
+    if(!grown)
+      return false;
+  }
+  return true;
+}
+
+// Return the player whose stones connect its two borders.
+Player BitboardHexBoard::flood_winner(FloodMethod method) const {
+  if(connects(Player::COMPUTER, method))
+    return Player::COMPUTER;
+  if(positions_occupied_ == total_positions_ ||
+     connects(Player::CONTESTANT, method))
+    return Player::CONTESTANT;
+  return Player::NONE;
+}
+
+// Store the given positions and their neighbors into out.  The
+// neighbors of position (row, column) are (row, column - 1) and
+// (row, column + 1), (row - 1, column) and (row - 1, column + 1), and
+// (row + 1, column - 1) and (row + 1, column).  So the positions and
+// their eastern neighbors, moved one row up, and the positions and their
+// western neighbors, moved one row down, give the neighbors in the other
+// rows.  The masks clear the border positions before the shifts, so no
+// bit crosses into another row, even when a row has no padding.
+void BitboardHexBoard::neighbors(const vector<BitboardWord>& in,
+				 vector<BitboardWord>& out) const {
+  const uint32_t words = in.size();
+  auto east = [&](uint32_t i) {
+    BitboardWord result = in[i] | (in[i] & not_east_[i]) << 1;
+    if(i > 0)
+      result |= (in[i - 1] & not_east_[i - 1]) >> (WORD_BITS - 1);
+    return result;
+  };
+  auto west = [&](uint32_t i) {
+    BitboardWord result = in[i] | (in[i] & not_west_[i]) >> 1;
+    if(i + 1 < words)
+      result |= (in[i + 1] & not_west_[i + 1]) << (WORD_BITS - 1);
+    return result;
+  };
+
+  for(uint32_t i = 0; i < words; i++) {
+    out[i] = east(i) | west(i);
+    if(i + row_words_ < words)
+      out[i] |= east(i + row_words_);
+    if(i >= row_words_)
+      out[i] |= west(i - row_words_);
+  }
+}
+
+// Add player to an empty position without the winner bookkeeping.
+void BitboardHexBoard::place_stone(Player player, Row row, Column column) {
+  assert(player != Player::NONE && legal_move(row, column));
+  set(bitboards_[static_cast<int>(player)], row, column);
+  set(occupied_, row, column);
+  positions_occupied_++;
+  moves_++;
+  placed_ = true;
+}
+
+// Print and draw the hex board.
+void BitboardHexBoard::draw() const {
+  draw_hex_board(size_, moves_, [this](Row row, Column column) {
+      return get_player(row, column);
+    });
+}
+
+// Return the number of empty positions.
+uint32_t BitboardHexBoard::empty_count() const {
+  uint32_t count = 0;
+
+  for(uint32_t i = 0; i < valid_.size(); i++)
+    count += __builtin_popcountll(valid_[i] & ~occupied_[i]);
+  return count;
+}
+
+// Get player who occupies the given row and column.
+Player BitboardHexBoard::get_player(Row row, Column column) const {
+  assert(row < size_ && column < size_);
+  if(test(bitboards_[static_cast<int>(Player::COMPUTER)], row, column))
+    return Player::COMPUTER;
+  if(test(bitboards_[static_cast<int>(Player::CONTESTANT)], row, column))
+    return Player::CONTESTANT;
+  return Player::NONE;
+}
+
+// Check if the given position is on the given border of the player or
+// next to a stone connected to it.
+bool BitboardHexBoard::touches(Player player, int border, Row row,
+			       Column column) const {
+  const vector<BitboardWord>& connected =
+    connected_[static_cast<int>(player)][border];
+  long neighbor_row, neighbor_column;
+
+  if(test(borders_[static_cast<int>(player)][border], row, column))
+    return true;
+  for(auto& delta: NEIGHBOR_DELTAS) {
+    neighbor_row = row + delta.row;
+    neighbor_column = column + delta.column;
+    if(neighbor_row >= 0 && neighbor_row < size_ &&
+       neighbor_column >= 0 && neighbor_column < size_ &&
+       test(connected, neighbor_row, neighbor_column))
+      return true;
+  }
+  return false;
+}
+
+// Store all legal moves into moves.  Each word yields its empty
+// positions lowest bit first.
+void BitboardHexBoard::legal_moves(vector<Position>& moves) const {
+  moves.clear();
+  for(uint32_t i = 0; i < valid_.size(); i++) {
+    BitboardWord empty = valid_[i] & ~occupied_[i];
+    while(empty) {
+      Column column = i % row_words_ * WORD_BITS + __builtin_ctzll(empty);
+      moves.push_back(Position(i / row_words_, column, size_));
+      empty &= empty - 1;
+    }
+  }
+}
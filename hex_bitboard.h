@@ -0,0 +1,201 @@
+// Header file for bitboard representation of the hex board.
+
+#ifndef HEX_BITBOARD_H_
+#define HEX_BITBOARD_H_
+
+#include "hex_game.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+typedef uint64_t BitboardWord;   // Word of a bitboard.
+const int WORD_BITS = 64;        // Bits per bitboard word.
+
+// Words per SIMD register of the target.
+#if defined(__AVX512F__)
+const int FLOOD_VECTOR_WIDTH = 8;
+#elif defined(__AVX2__)
+const int FLOOD_VECTOR_WIDTH = 4;
+#else
+const int FLOOD_VECTOR_WIDTH = 2;
+#endif
+
+// Consecutive words of a bitboard as a GCC vector that fills a SIMD
+// register of the target.  The alignment is lowered to that of a word,
+// so vectors may start at any word of vector<BitboardWord> storage.
+typedef BitboardWord FloodVector
+  __attribute__((vector_size(FLOOD_VECTOR_WIDTH * sizeof(BitboardWord)),
+		 aligned(8)));
+
+// Methods of the flood of BitboardHexBoard::connects().
+// - WORD: sweep the words down and up the board in place, one word at a
+//   time.  Each word takes the flood of the words updated before it in
+//   the same sweep, and fills its own runs of stones completely, so a
+//   sweep carries the flood along a whole path that runs its way.
+// - SIMD: grow the flood by one step of neighbors per pass, with
+//   FLOOD_VECTOR_WIDTH words per operation.  Passes have no dependences
+//   between words, so they vectorize, but they need as many passes as
+//   the path is long.
+enum class FloodMethod { WORD, SIMD };
+
+// A hex board with one bitboard per player.  It has the semantics of
+// HexBoard for adding players, getting players and the winner, so it is
+// a drop-in board for GameRunner, but it keeps no union-finds.
+//
+// A bitboard holds one bit per position, row by row, and every row is
+// padded to whole words, so the row above or below a position is a
+// fixed number of words away, and a row never shares a word with
+// another.  Padding bits are always 0.  Shifting a bitboard by one bit
+// moves every position to its eastern or western neighbor, once the
+// precomputed masks have cleared the positions on the border that the
+// shift would move into the next row.  The six neighbors of all the
+// positions of a bitboard are thus a few shifts, masks and ors per word.
+//
+// Positions filled by place_stone(), e.g. in playouts, skip that
+// bookkeeping, and connects() and flood_winner() then test a position
+// from scratch: they flood the stones of a player from one border with
+// shifts and masks until the flood stops growing, and check whether it
+// reached the other border.
+//
+// For the winner, the board keeps for each player and each of its two
+// borders the stones connected to that border.  A new stone connects
+// both borders, and wins, exactly when it is on or next to each of them,
+// so the check is a few bit tests.  When the stone connects one border,
+// its group is added to the connected stones by a depth-first search,
+// which adds every stone at most once per border and game, so the cost
+// per move is constant on average.
+class BitboardHexBoard {
+ public:
+  // Construct a hex board.
+  BitboardHexBoard(uint32_t size);
+  // Add and validate a player to a given position on the board.  Not
+  // allowed after place_stone().
+  Result add_player_position(Player player, Row row, Column column);
+  // Check if the stones of the player connect its two borders, by a
+  // flood with the given method.
+  bool connects(Player player, FloodMethod method=FloodMethod::WORD) const;
+  // Print and draw the hex board.
+  void draw() const;
+  // Return the number of empty positions.
+  uint32_t empty_count() const;
+  // Return the player whose stones connect its two borders, or NONE, by
+  // a flood with the given method.  On a full board, only the computer
+  // is flooded, since one player always connects.
+  Player flood_winner(FloodMethod method=FloodMethod::WORD) const;
+  // Indicate if the game is over.
+  bool game_over() const {
+    return winner() != Player::NONE ||
+      positions_occupied_ == total_positions_;
+  }
+  // Get player who occupies a given position.
+  Player get_player(const Position& position) const {
+    return get_player(position.row(), position.column());
+  }
+  // Get player who occupies the given row and column.
+  Player get_player(Row row, Column column) const;
+  // Check if a player may move to the given row and column, i.e. the
+  // position is on the board and empty.
+  bool legal_move(Row row, Column column) const {
+    return row < size_ && column < size_ &&
+      !test(occupied_, row, column);
+  }
+  // Store all legal moves in row-major order into moves.
+  void legal_moves(vector<Position>& moves) const;
+  // Return board size.
+  uint32_t size() const { return size_; }
+  // Store the given positions and their neighbors into out, which must
+  // have the size of the bitboards and differ from in.
+  void neighbors(const vector<BitboardWord>& in,
+		 vector<BitboardWord>& out) const;
+  // Add player to an empty position of the board without the winner
+  // bookkeeping, e.g. to fill the board in a playout.  winner() is not
+  // updated, so the position must be tested with flood_winner().
+  void place_stone(Player player, Row row, Column column);
+  // Return bitboard of the given player.
+  const vector<BitboardWord>& player_bitboard(Player player) const {
+    return bitboards_[static_cast<int>(player)];
+  }
+  // Get winner.
+  Player winner() const { return winner_; }
+
+ private:
+  // Add the group of the given stone of the player to the stones
+  // connected to the given border.
+  void connect_group(Player player, int border, Row row, Column column);
+  // Grow the flood of the flood buffers by passes of vector operations
+  // until it stops growing.  Return whether it reached the target.
+  bool flood_simd(const vector<BitboardWord>& target) const;
+  // Grow the flood of the flood buffers in place, in sweeps down and up,
+  // until it stops growing.  Return whether it reached the target.
+  bool flood_word(const vector<BitboardWord>& target) const;
+  // Return whether the flood has reached the target.
+  bool flood_reached(const vector<BitboardWord>& target) const {
+    for(uint32_t i = 0; i < target.size(); i++)
+      if(flood_[flood_guard_ + i] & target[i])
+	return true;
+    return false;
+  }
+  // Check if the given position is on the given border of the player or
+  // next to a stone connected to it.
+  bool touches(Player player, int border, Row row, Column column) const;
+  // Set the bit of the given position.
+  void set(vector<BitboardWord>& bitboard, Row row, Column column) const {
+    bitboard[word(row, column)] |= BitboardWord(1) << (column % WORD_BITS);
+  }
+  // Test the bit of the given position.
+  bool test(const vector<BitboardWord>& bitboard, Row row,
+	    Column column) const {
+    return bitboard[word(row, column)] >> (column % WORD_BITS) & 1;
+  }
+  // Return index of the word of the given position.
+  uint32_t word(Row row, Column column) const {
+    return row * row_words_ + column / WORD_BITS;
+  }
+  // Bitboard of each player.
+  vector<BitboardWord> bitboards_[2];
+  // Positions of the two borders of each player: north and south for
+  // the computer, west and east for the contestant.
+  vector<BitboardWord> borders_[2][2];
+  // Stones of each player connected to each of its borders.
+  vector<BitboardWord> connected_[2][2];
+  // Flood buffers: the flood, the flood of the next pass, the stones
+  // flooded, and the flood masked by not_east_ and not_west_.  They hold
+  // the words of the board between flood_guard_ words of zeros on each
+  // side, so that the neighbors of any word are loaded without bounds
+  // checks.  Their length is a multiple of FLOOD_VECTOR_WIDTH.
+  mutable vector<BitboardWord> flood_, flood_next_, flood_stones_,
+    flood_east_, flood_west_;
+  // Words of zeros before and after the board in the flood buffers.
+  uint32_t flood_guard_;
+  // not_east_ and not_west_ in the layout of the flood buffers.
+  vector<BitboardWord> flood_not_east_, flood_not_west_;
+  // Number of moves.
+  uint32_t moves_;
+  // Positions not on the eastern border.
+  vector<BitboardWord> not_east_;
+  // Positions not on the western border.
+  vector<BitboardWord> not_west_;
+  // Positions occupied by either player.
+  vector<BitboardWord> occupied_;
+  // True once place_stone() has skipped the winner bookkeeping.
+  bool placed_;
+  // Number of positions occupied.
+  uint32_t positions_occupied_;
+  // Stack of the search of connect_group(), with room for all positions,
+  // so that it never allocates.
+  vector<Position> search_stack_;
+  // Words per row.
+  uint32_t row_words_;
+  // Board size.
+  uint32_t size_;
+  // Total number of positions on the board.
+  uint32_t total_positions_;
+  // All positions of the board.
+  vector<BitboardWord> valid_;
+  // Winner identifier.
+  Player winner_;
+};
+
+#endif // HEX_BITBOARD_H_
@@ -0,0 +1,176 @@
+// Unit tests for bitboard representation of the hex board using
+// Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "hex_bitboard.h"
+#include "hex_game.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// The game runner must accept the bitboard.
+template class GameRunner<BitboardHexBoard>;
+
+// Play random games on both boards and check that they agree after
+// every move.
+static void check_random_games(uint32_t size, int games, unsigned seed) {
+  mt19937 generator(seed);
+  vector<Position> moves;
+
+  for(int game = 0; game < games; game++) {
+    HexBoard board = HexBoard(size);
+    BitboardHexBoard bitboard = BitboardHexBoard(size);
+    vector<Position> positions;
+    for(Row row = 0; row < size; row++)
+      for(Column column = 0; column < size; column++)
+	positions.push_back(Position(row, column, size));
+    shuffle(positions.begin(), positions.end(), generator);
+
+    // Moves after the game is over must fail on both boards too.
+    for(size_t i = 0; i < positions.size(); i++) {
+      Player player = i % 2 ? Player::CONTESTANT : Player::COMPUTER;
+      Position& position = positions[i];
+      ASSERT_EQ(board.add_player_position(player, position.row(),
+					  position.column()),
+		bitboard.add_player_position(player, position.row(),
+					     position.column()))
+	<< "Results differ at move: " << i << " size: " << size;
+      ASSERT_EQ(board.winner(), bitboard.winner())
+	<< "Winners differ at move: " << i << " size: " << size;
+      ASSERT_EQ(board.game_over(), bitboard.game_over())
+	<< "Game over differs at move: " << i << " size: " << size;
+      ASSERT_EQ(board.get_player(position), bitboard.get_player(position))
+	<< "Players differ at move: " << i << " size: " << size;
+    }
+    EXPECT_NE(Player::NONE, bitboard.winner()) << "Someone should win.";
+
+    // Empty positions match the layout.
+    bitboard.legal_moves(moves);
+    EXPECT_EQ(bitboard.empty_count(), moves.size())
+      << "Legal moves should be the empty positions.";
+    for(auto& move: moves)
+      EXPECT_EQ(Player::NONE, board.get_player(move))
+	<< "Legal move should be empty: " << move;
+  }
+}
+
+TEST(hex_bitboard_test_suite, test_add_player_position) {
+  BitboardHexBoard board = BitboardHexBoard(7);
+  Result invalid = { false, INVALID_POSITION };
+  Result occupied = { false, OCCUPIED_POSITION };
+  EXPECT_EQ(invalid, board.add_player_position(Player::COMPUTER, 10, 1))
+    << "Row 10 should be invalid.";
+  EXPECT_EQ(invalid, board.add_player_position(Player::CONTESTANT, 0, 7))
+    << "Column 7 should be invalid.";
+  EXPECT_EQ(SUCCESS_RESULT, board.add_player_position(Player::COMPUTER, 3, 4))
+    << "Empty position should be added.";
+  EXPECT_EQ(occupied, board.add_player_position(Player::CONTESTANT, 3, 4))
+    << "Position should be occupied.";
+  EXPECT_EQ(Player::COMPUTER, board.get_player(3, 4)) << "Wrong player.";
+  EXPECT_EQ(Player::NONE, board.get_player(4, 3)) << "Wrong player.";
+  EXPECT_FALSE(board.legal_move(3, 4)) << "Occupied move is illegal.";
+  EXPECT_FALSE(board.legal_move(7, 0)) << "Off-board move is illegal.";
+  EXPECT_TRUE(board.legal_move(4, 3)) << "Empty move is legal.";
+  EXPECT_EQ(48, board.empty_count()) << "Empty count is wrong.";
+}
+
+TEST(hex_bitboard_test_suite, test_winner) {
+  // The contestant's chain from west to east zigzags through the
+  // neighbors (row + 1, column - 1).
+  BitboardHexBoard board = BitboardHexBoard(4);
+  Row rows[] = { 3, 2, 2, 1 };
+  Column columns[] = { 0, 1, 2, 3 };
+  for(int i = 0; i < 4; i++) {
+    EXPECT_EQ(Player::NONE, board.winner()) << "No winner yet: " << i;
+    board.add_player_position(Player::CONTESTANT, rows[i], columns[i]);
+  }
+  EXPECT_EQ(Player::CONTESTANT, board.winner()) << "Contestant should win.";
+  EXPECT_TRUE(board.game_over()) << "Game should be over.";
+  Result over = { false, GAME_OVER };
+  EXPECT_EQ(over, board.add_player_position(Player::COMPUTER, 0, 0))
+    << "No move after game over.";
+}
+
+TEST(hex_bitboard_test_suite, test_neighbors) {
+  // Neighbors of each single stone match Position::neighbors().
+  for(uint32_t size: { 3u, 64u, 70u }) {
+    const uint32_t row_words = (size + WORD_BITS - 1) / WORD_BITS;
+    BitboardHexBoard board = BitboardHexBoard(size);
+    BitboardHexBoard single = BitboardHexBoard(size);
+    vector<BitboardWord> out(single.player_bitboard(Player::COMPUTER));
+    for(Row row = 0; row < size; row++)
+      for(Column column = 0; column < size; column++) {
+	single = board;
+	single.add_player_position(Player::COMPUTER, row, column);
+	single.neighbors(single.player_bitboard(Player::COMPUTER), out);
+	vector<BitboardWord> expect(out.size(), 0);
+	vector<Position> positions = Position(row, column, size).neighbors();
+	positions.push_back(Position(row, column));
+	for(auto& position: positions)
+	  expect[position.row() * row_words + position.column() / WORD_BITS] |=
+	    BitboardWord(1) << position.column() % WORD_BITS;
+	ASSERT_TRUE(expect == out)
+	  << "Neighbors are wrong for: " << Position(row, column)
+	  << " size: " << size;
+      }
+  }
+}
+
+TEST(hex_bitboard_test_suite, test_random_games) {
+  // One word per row with and without padding, and two words per row.
+  for(uint32_t size: { 1u, 2u, 5u, 11u })
+    check_random_games(size, 200, size);
+  for(uint32_t size: { 63u, 64u, 65u, MAX_SIZE })
+    check_random_games(size, 3, size);
+}
+
+TEST(hex_bitboard_test_suite, test_flood_winner) {
+  // Both floods agree with winner() after every move of random games.
+  const FloodMethod methods[] = { FloodMethod::WORD, FloodMethod::SIMD };
+  mt19937 generator(1);
+  for(uint32_t size: { 1u, 2u, 5u, 11u, 64u, 65u }) {
+    BitboardHexBoard board = BitboardHexBoard(size);
+    vector<Position> moves;
+    board.legal_moves(moves);
+    shuffle(moves.begin(), moves.end(), generator);
+    for(int i = 0; !board.game_over(); i++) {
+      Player player = i % 2 ? Player::CONTESTANT : Player::COMPUTER;
+      board.add_player_position(player, moves[i].row(), moves[i].column());
+      for(FloodMethod method: methods)
+	ASSERT_EQ(board.winner(), board.flood_winner(method))
+	  << "Flood winner is wrong at move: " << i << " size: " << size;
+    }
+  }
+}
+
+TEST(hex_bitboard_test_suite, test_place_stone) {
+  // Boards filled by place_stone() have the winner of the same game
+  // played by add_player_position() to the end.
+  mt19937 generator(2);
+  for(uint32_t size: { 1u, 3u, 11u, 63u, 64u, 65u, MAX_SIZE }) {
+    for(int game = 0; game < 5; game++) {
+      BitboardHexBoard board = BitboardHexBoard(size);
+      BitboardHexBoard playout = BitboardHexBoard(size);
+      vector<Position> moves;
+      board.legal_moves(moves);
+      shuffle(moves.begin(), moves.end(), generator);
+      for(size_t i = 0; i < moves.size(); i++) {
+	Player player = i % 2 ? Player::CONTESTANT : Player::COMPUTER;
+	board.add_player_position(player, moves[i].row(), moves[i].column());
+	playout.place_stone(player, moves[i].row(), moves[i].column());
+      }
+      EXPECT_EQ(0, playout.empty_count()) << "Board should be full.";
+      EXPECT_EQ(board.winner(), playout.flood_winner(FloodMethod::WORD))
+	<< "Word flood winner is wrong for size: " << size;
+      EXPECT_EQ(board.winner(), playout.flood_winner(FloodMethod::SIMD))
+	<< "SIMD flood winner is wrong for size: " << size;
+      EXPECT_EQ(board.winner() == Player::CONTESTANT,
+		playout.connects(Player::CONTESTANT, FloodMethod::SIMD))
+	<< "Exactly one player connects a full board.";
+    }
+  }
+}
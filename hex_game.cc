@@ -7,6 +7,9 @@
 #include <assert.h>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -15,22 +18,66 @@ using namespace std;
 
 const int BORDER_LENGTH = 60;  // Border length for hex board display.
 
+// Draw a given row.
+static void draw_row(uint32_t size, Row row,
+		     const function<Player(Row, Column)>& get_player) {
+  const string separator = " - ";
+  
+  cout << setw(2*row) << "";
+  for(Column i = 0; i < size; i++) {
+    cout << player_symbol[static_cast<int>(get_player(row, i))];
+    if(i == size-1)
+      cout << endl;
+    else
+      cout << separator;
+  }
+}
+
+// Draw a row separator.
+static void draw_row_separator(uint32_t size, Row row) {
+  const string separator = " / \\";
+  
+  cout << setw(2*row+1) << "" << '\\';
+  for(Column i = 1; i < size; i++)
+    cout << separator;
+  cout << endl;
+}
+
+// Print board move.
+static void print_move(uint32_t moves) {
+  cout << "BOARD (";
+  if(moves)
+    cout << "after Move " << moves;
+  else 
+    cout << "no moves";
+  cout << ")" << endl << endl;
+}
+
+// Print and draw a hex board.
+void draw_hex_board(uint32_t size, uint32_t moves,
+		    const function<Player(Row, Column)>& get_player) {
+  string border = string(BORDER_LENGTH, '-');
+
+  cout << border << endl;
+  print_move(moves);
+  for(Row row = 0; row < size; row++) { 
+    draw_row(size, row, get_player);
+    if(row != size-1)
+      draw_row_separator(size, row);
+  }
+  cout << endl << border << endl << endl;
+}
+
 // ==========
 //  Position
 // ==========
 
 // Return all neighboring positions.
 vector<Position> Position::neighbors() const {
-  vector<PositionDelta> deltas = {{ -1, 0 },
-				  { 1, 0 }, 
-				  { 0, 1 },
-				  { 0, -1 },
-				  { -1, 1 },
-				  { 1, -1 }};
   vector<Position> result;
   long new_row, new_column;
 
-  for(auto& delta: deltas) {
+  for(auto& delta: NEIGHBOR_DELTAS) {
     new_row = row_ + delta.row;
     new_column = column_ + delta.column;
 
@@ -44,6 +91,54 @@ vector<Position> Position::neighbors() const {
   return result;
 }
 
+// ==============
+//  HexAdjacency
+// ==============
+
+// Build the table of the given board size.  Neighbors follow the order of
+// NEIGHBOR_DELTAS, as in Position::neighbors().  A cell of a board of
+// size 1 is on all four borders.
+HexAdjacency::HexAdjacency(uint32_t size)
+  : offsets_({ 0 }),
+    size_(size) {
+  long new_row, new_column;
+
+  for(long row = 0; row < size_; row++)
+    for(long column = 0; column < size_; column++) {
+      for(auto& delta: NEIGHBOR_DELTAS) {
+	new_row = row + delta.row;
+	new_column = column + delta.column;
+	if(new_row < 0 || new_row >= size_ ||
+	   new_column < 0 || new_column >= size_)
+	  continue;
+	vertices_.push_back(new_row * size_ + new_column);
+      }
+      offsets_.push_back(vertices_.size());
+      if(row == 0)
+	vertices_.push_back(COMPUTER_NORTH_VERTEX);
+      if(row == size_ - 1)
+	vertices_.push_back(COMPUTER_SOUTH_VERTEX);
+      if(column == size_ - 1)
+	vertices_.push_back(CONTESTANT_EAST_VERTEX);
+      if(column == 0)
+	vertices_.push_back(CONTESTANT_WEST_VERTEX);
+      offsets_.push_back(vertices_.size());
+    }
+}
+
+// Return the table of the given board size.  Tables live until exit, so
+// the references handed out stay valid.
+const HexAdjacency& HexAdjacency::of_size(uint32_t size) {
+  static map<uint32_t, unique_ptr<HexAdjacency> > tables;
+  static mutex tables_mutex;
+  lock_guard<mutex> lock(tables_mutex);
+  unique_ptr<HexAdjacency>& table = tables[size];
+
+  if(!table)
+    table.reset(new HexAdjacency(size));
+  return *table;
+}
+
 // ==========
 //  HexBoard 
 // ==========
@@ -64,7 +159,7 @@ Result HexBoard::add_player_position(Player player,
     return result;
 
   // Add player to the position and check if it wins.
-  layout_[position.row()][position.column()] = player;
+  layout_[position_vertex(position)] = player;
   positions_occupied_++;
   moves_++;
   update_player_move(player, position);
@@ -72,6 +167,34 @@ Result HexBoard::add_player_position(Player player,
   return SUCCESS_RESULT;
 }
 
+// Add player to a given position and record the move.
+Result HexBoard::make_move(Player player, Row row, Column column) {
+  MoveRecord record = { row, column, player,
+			player_union_find(player).checkpoint(), winner_, 0 };
+  Result result = add_player_position(player, row, column);
+
+  if(result.status) {
+    record.moves = moves_;
+    move_records_.push_back(record);
+  }
+  return result;
+}
+
+// Undo the last move recorded by make_move().
+void HexBoard::unmake_move() {
+  assert(!move_records_.empty());
+  MoveRecord& record = move_records_.back();
+
+  // The rollback would also undo the unions of any later move.
+  assert(record.moves == moves_);
+  layout_[record.row * size_ + record.column] = Player::NONE;
+  positions_occupied_--;
+  moves_--;
+  player_union_find(record.player).rollback(record.checkpoint);
+  winner_ = record.winner;
+  move_records_.pop_back();
+}
+
 // Check if this player is a winner.
 bool HexBoard::check_player_winner(Player player) {
 
@@ -118,97 +241,40 @@ Result HexBoard::check_add_position(Position position) const {
 
 // Print and draw the hex board.
 void HexBoard::draw() const {
-  string border = string(BORDER_LENGTH, '-');
-
-  cout << border << endl;
-  print_move();
-  for(Row row = 0; row < size_; row++) { 
-    draw_row(row);
-    if(row != size_-1)
-      draw_row_separator(row);
-  }
-  cout << endl << border << endl << endl;
-}
-
-// Draw a given row.
-void HexBoard::draw_row(Row row) const {
-  const string separator = " - ";
-  
-  cout << setw(2*row) << "";
-  for(Column i = 0; i < size_; i++) {
-    Position position = Position(row, i);
-    cout << get_player_symbol(position);
-    if(i == size_-1)
-      cout << endl;
-    else
-      cout << separator;
-  }
-}
-
-// Draw a row separator.
-void HexBoard::draw_row_separator(Row row) const {
-  const string separator = " / \\";
-  
-  cout << setw(2*row+1) << "" << '\\';
-  for(int i = 0; i < size_-1; i++)
-    cout << separator;
-  cout << endl;
+  draw_hex_board(size_, moves_, [this](Row row, Column column) {
+      return layout_[row * size_ + column];
+    });
 }
 
-// Initialize the hex board.
+// Initialize the hex board.  Every move records at most one move and
+// logs few unions, so reserving room for all positions keeps moves free
+// of allocation.
 void HexBoard::init_board() {
-  for(Row i = 0; i < size_; i++)
-    layout_.push_back(vector<Player>(size_, Player::NONE));
-}
-
-// Print board move.
-void HexBoard::print_move() const {
-  cout << "BOARD (";
-  if(moves_)
-    cout << "after Move " << moves_;
-  else 
-    cout << "no moves";
-  cout << ")" << endl << endl;
+  layout_.assign(total_positions_, Player::NONE);
+  move_records_.reserve(total_positions_);
 }
 
 // Update player union-find based on the player's move along the border.
+// The position of a board of size 1 is on both borders of each player.
 void HexBoard::update_border_move(Player player, Position& position) {
-  Vertex vertex = position_vertex(position);
-
-  switch(player) {
-  case Player::COMPUTER:
-    if(north_border(position))
-      computer_uf_.join(COMPUTER_NORTH_VERTEX, vertex);
-    else if(south_border(position))
-      computer_uf_.join(COMPUTER_SOUTH_VERTEX, vertex);
-    break;
-  case Player::CONTESTANT:
-    if(east_border(position))
-      contestant_uf_.join(CONTESTANT_EAST_VERTEX, vertex);
-    else if(west_border(position))
-      contestant_uf_.join(CONTESTANT_WEST_VERTEX, vertex);
-    break;
-  default:
+  RollbackUnionFind& player_uf = player_union_find(player);
+  Vertex this_vertex = position_vertex(position);
 
-    // This should not occur.
-    assert(false);
-  }
+  for(Vertex border: adjacency_->borders(this_vertex))
+    if(virtual_vertex_player(border) == player)
+      player_uf.join(border, this_vertex);
 }
 
 // Update player union-find based on the player's move.
 void HexBoard::update_player_move(Player player, Position& position) {
-  UnionFind& player_uf = player_union_find(player);
+  RollbackUnionFind& player_uf = player_union_find(player);
   Vertex this_vertex = position_vertex(position);
-  Vertex neighbor_vertex;
 
   // Iterate over all neighboring positions and add edges connecting the
   // position vertices if needed.
-  for(auto& neighbor: position.neighbors()) {
-    if(get_player(neighbor) == player) {
-      neighbor_vertex = position_vertex(neighbor);
-      player_uf.join(neighbor_vertex, this_vertex);
-    }
-  }
+  for(Vertex neighbor: adjacency_->neighbors(this_vertex))
+    if(layout_[neighbor] == player)
+      player_uf.join(neighbor, this_vertex);
 
   // Update any border move.
   update_border_move(player, position);
@@ -253,79 +319,3 @@ Position PlayerBase::move() const {
        << MAX_ATTEMPTS << " attempts."  << endl; 
   return Position(MAX_SIZE, MAX_SIZE);
 }
-
-// ============
-//  GameRunner
-// ============
-
-// Attempt to add the player's move to the hex board.
-Result GameRunner::add_player_move(PlayerBase& player,
-				   Row& row,
-				   Column& column) {
-  Player pl = player.id();
-  Result result;
-
-  for(int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
-    result = hex_board_.add_player_position(pl, row, column);
-    if(result.status)
-      return result; 
-    cout << "Fail to add move from " << player.name()
-	 << " to the hex board due to: "
-	 << ErrorCodeString[result.error] << '.' << endl;
-    get_player_move(player, row, column);
-  }
-  return result;
-}
-
-// Attempt to get the player's move.
-Result GameRunner::get_player_move(PlayerBase& player,
-				   Row& row,
-				   Column& column) const {
-  Position position = player.move(); 
-
-  if(!position.valid()) {
-    cout << "Ignore move from " << player.name() << '.' << endl;
-    return { false, INVALID_POSITION };
-  }
-  // Return success result with row and column numbers.
-  row = position.row();
-  column = position.column();
-  return SUCCESS_RESULT;
-}
-
-// Run and manage the hex board game.
-Player GameRunner::run() {
-  vector<PlayerBase> players = { player1_, player2_ };
-  Row row;
-  Column column;
-  Result result;
-  Player winner;
-
-  while(!hex_board_.game_over()) {
-    for(auto& player: players) {
-      hex_board_.draw();
-      show_current_player_move(player);
-      result = get_player_move(player, row, column);
-
-      // Skip this player if there is no valid move.
-      if(!result.status)
-	continue;
-      result = add_player_move(player, row, column);
-
-      // Skip this player if there is a failure.
-      if(!result.status) {
-	cout << "Fail to add move from " << player.name()
-	     << " after " << MAX_ATTEMPTS << " attempts."  << endl; 
-	continue;
-      }
-      if(hex_board_.game_over())
-	break;
-      moves_++;
-    }
-  }
-  winner = hex_board_.winner();
-  cout << get_player_name(winner) << " wins!" << endl;
-  hex_board_.draw();
-  return winner;
-}
-
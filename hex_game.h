@@ -6,6 +6,7 @@
 #include "union_find.h"
 
 #include <assert.h>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -34,6 +35,15 @@ const Vertex COMPUTER_SOUTH_VERTEX = -2;
 const Vertex CONTESTANT_WEST_VERTEX = -3;
 // Terminating vertex for contestant at the eastern border.
 const Vertex CONTESTANT_EAST_VERTEX = -4;
+// Number of virtual vertices.
+const Vertex VIRTUAL_VERTICES = 4;
+
+// Return the player whose border the given virtual vertex terminates.
+inline Player virtual_vertex_player(Vertex vertex) {
+  assert(-VIRTUAL_VERTICES <= vertex && vertex < 0);
+  return vertex >= COMPUTER_SOUTH_VERTEX ? Player::COMPUTER :
+    Player::CONTESTANT;
+}
 // Unit cost for edges connecting position vertices. 
 const int UNIT_COST = 1;
 // Maximum attempts.
@@ -59,6 +69,16 @@ struct PositionDelta {
   int row, column;
 };
 
+// Number of neighbors of an inner position.
+const int NEIGHBOR_COUNT = 6;
+// Deltas from a position to its neighbors on the hex lattice.
+const PositionDelta NEIGHBOR_DELTAS[NEIGHBOR_COUNT] = {{ -1, 0 },
+						       { 1, 0 },
+						       { 0, 1 },
+						       { 0, -1 },
+						       { -1, 1 },
+						       { 1, -1 }};
+
 // Result of an action on the hex board and by the game runner.  Possible
 // actions include:
 // - Add player move to the hex board.
@@ -91,6 +111,11 @@ inline bool is_int(string& st) {
   return true;
 }
 
+// Print and draw a hex board of the given size after the given number of
+// moves, with the player on each position from get_player.
+void draw_hex_board(uint32_t size, uint32_t moves,
+		    const function<Player(Row, Column)>& get_player);
+
 // A class to encapsulate the row & column of the hex board position.
 class Position {
  public:
@@ -124,21 +149,67 @@ class Position {
   Row row_;
 };
 
+// Adjacency of the cells of a hex board of one size, in flat form: cell
+// row * size + column lists its neighboring cells, then the virtual
+// vertices of the borders it is on.  Tables are built once per size and
+// shared by all boards of that size, so a move reads its neighbors from
+// the table without building positions or vectors.
+class HexAdjacency {
+ public:
+  // Range of adjacent vertices of a cell, for range-based for loops.
+  struct VertexRange {
+    const Vertex* first;
+    const Vertex* last;
+    const Vertex* begin() const { return first; }
+    const Vertex* end() const { return last; }
+  };
+  // Return the table of the given board size, built on first use.  Safe
+  // to call from several threads.
+  static const HexAdjacency& of_size(uint32_t size);
+  // Return the virtual vertices of the borders the given cell is on.
+  VertexRange borders(Vertex cell) const {
+    return range(offsets_[2 * cell + 1], offsets_[2 * cell + 2]);
+  }
+  // Return the number of cells.
+  Vertex cells() const { return size_ * size_; }
+  // Return the neighboring cells of the given cell.
+  VertexRange neighbors(Vertex cell) const {
+    return range(offsets_[2 * cell], offsets_[2 * cell + 1]);
+  }
+  // Return board size.
+  uint32_t size() const { return size_; }
+
+ private:
+  // Build the table of the given board size.
+  explicit HexAdjacency(uint32_t size);
+  // Return the range of the vertices between the given offsets.
+  VertexRange range(uint32_t begin, uint32_t end) const {
+    return VertexRange{ vertices_.data() + begin, vertices_.data() + end };
+  }
+  // Offsets into vertices_ of each cell: of its neighbors, then of its
+  // borders, with the end of the last cell.
+  vector<uint32_t> offsets_;
+  // Board size.
+  uint32_t size_;
+  // Adjacent vertices of all cells.
+  vector<Vertex> vertices_;
+};
+
 // A class to represent a hex board.  It performs the following actions:
 // - Add and validate a player to a given position on the board.
 // - Determine winner.
+// - Make and unmake moves, e.g. for game-tree search.
 // - Print and draw the board.
 class HexBoard {
  public:
   // Construct a hex board.
   HexBoard(uint32_t size)
-    : computer_uf_(UnionFind()),
-      contestant_uf_(UnionFind()),
+    : adjacency_(&HexAdjacency::of_size(size)),
+      computer_uf_(RollbackUnionFind(size * size, VIRTUAL_VERTICES)),
+      contestant_uf_(RollbackUnionFind(size * size, VIRTUAL_VERTICES)),
       moves_(0),
       positions_occupied_(0),
       size_(size),
-      max_column_(size-1),
-      max_row_(size-1),
       total_positions_(size*size),
       winner_(Player::NONE) { init_board(); }
   // Add and validate a player to a given position on the board.
@@ -151,46 +222,38 @@ class HexBoard {
   }
   // Get player who occupies a given position.
   Player get_player(Position& position) const {
-    return layout_[position.row()][position.column()];
+    return layout_[position.row() * size_ + position.column()];
   }
+  // Add player to a given position like add_player_position(), and
+  // record the move so that unmake_move() can undo it.
+  Result make_move(Player player, Row row, Column column);
+  // Undo the last move recorded by make_move(), which must be the last
+  // move on the board: a later add_player_position() cannot be undone.
+  void unmake_move();
   // Get winner.
   Player winner() const { return winner_; }
 
  private:
+  // Record of a move for unmake_move(): the position, the player, the
+  // union-find checkpoint of the player and the winner before the move,
+  // and the number of moves after it.
+  struct MoveRecord {
+    Row row;
+    Column column;
+    Player player;
+    int checkpoint;
+    Player winner;
+    uint32_t moves;
+  };
   // Validate position before adding player to a position on the board.
   Result check_add_position(Position position) const;
   // Check if this player is a winner.  This method uses union-find for the
   // player and check if there is a path between the virtual vertices.
   bool check_player_winner(Player player);
-  // Draw a given row.
-  void draw_row(Row row) const;
-  // Draw a row separator following a given row.
-  void draw_row_separator(Row row) const;
-  // Get player symbol on the given board position.
-  char get_player_symbol(Position& position) const {
-    int pl = static_cast<int>(get_player(position));
-    return player_symbol[pl];
-  }
   // Initialize the hex board.
   void init_board();
-  // Check if the position is on the easthern border of the board.
-  bool east_border(Position& position) const {
-    return position.column() == max_column_;
-  }
-  // Check if the position is on the northern border of the board.
-  bool north_border(Position& position) const {
-    return position.row() == 0;
-  }
-  // Check if the position is on the southern border of the board.
-  bool south_border(Position& position) const {
-    return position.row() == max_row_;
-  }
-  // Check if the position is on the westhern border of the board.
-  bool west_border(Position& position) const {
-    return position.column() == 0;
-  }
   // Return player's union-find.
-  UnionFind& player_union_find(Player player) {
+  RollbackUnionFind& player_union_find(Player player) {
     switch(player) {
     case Player::COMPUTER: return computer_uf_;
     case Player::CONTESTANT: return contestant_uf_;
@@ -201,22 +264,21 @@ class HexBoard {
   Vertex position_vertex(Position& position) {
     return position.row() * size_ + position.column();
   }
-  // Print board move.
-  void print_move() const;
   // Update player union-find based on the player's move along the border.
   void update_border_move(Player player, Position& position);
   // Update player union-find based on the player's move.
   void update_player_move(Player player, Position& position);
-  // Union-find's for computer and contestant.
-  UnionFind computer_uf_, contestant_uf_;
-  // Board layout.
-  vector<vector<Player> > layout_;
-  // Max column number.
-  Column max_column_;
-  // Max row number.
-  Row max_row_;
+  // Adjacency table of the board size, shared with other boards.
+  const HexAdjacency* adjacency_;
+  // Union-find's for computer and contestant over the position vertices
+  // and the virtual vertices.  They log unions for unmake_move().
+  RollbackUnionFind computer_uf_, contestant_uf_;
+  // Board layout, indexed by position vertex.
+  vector<Player> layout_;
   // Number of moves.
   uint32_t moves_;
+  // Moves recorded by make_move(), latest last.
+  vector<MoveRecord> move_records_;
   // Number of positions occupied.
   uint32_t positions_occupied_;
   // Total number of positions on the board.
@@ -259,10 +321,13 @@ class PlayerBase {
 // - If any player's move cannot be added to the hex board, try to get
 //   another move from the same player up to MAX_ATTEMPTS.
 // - Announce winner and stop the game. 
+// The board type is a template parameter, so that any board with the
+// interface of HexBoard, such as BitboardHexBoard, can be played.
+template <class Board>
 class GameRunner {
  public:
   // Construct a game runner.
-  GameRunner(HexBoard& hb, PlayerBase& player1, PlayerBase& player2)
+  GameRunner(Board& hb, PlayerBase& player1, PlayerBase& player2)
     : hex_board_(hb),
       player1_(player1),
       player2_(player2),
@@ -286,9 +351,86 @@ class GameRunner {
     cout << "Move " << moves_ << ": " << player.name()
 	 << '(' << player_symbol[pl] << ')' << endl;
   }
-  HexBoard hex_board_;
+  Board hex_board_;
   PlayerBase player1_, player2_;
   int moves_;
 };
 
+// Methods of GameRunner, which are defined in the header since it is a
+// template.
+
+// Attempt to add the player's move to the hex board.
+template <class Board>
+Result GameRunner<Board>::add_player_move(PlayerBase& player,
+					  Row& row,
+					  Column& column) {
+  Player pl = player.id();
+  Result result;
+
+  for(int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+    result = hex_board_.add_player_position(pl, row, column);
+    if(result.status)
+      return result; 
+    cout << "Fail to add move from " << player.name()
+	 << " to the hex board due to: "
+	 << ErrorCodeString[result.error] << '.' << endl;
+    get_player_move(player, row, column);
+  }
+  return result;
+}
+
+// Attempt to get the player's move.
+template <class Board>
+Result GameRunner<Board>::get_player_move(PlayerBase& player,
+					  Row& row,
+					  Column& column) const {
+  Position position = player.move(); 
+
+  if(!position.valid()) {
+    cout << "Ignore move from " << player.name() << '.' << endl;
+    return { false, INVALID_POSITION };
+  }
+  // Return success result with row and column numbers.
+  row = position.row();
+  column = position.column();
+  return SUCCESS_RESULT;
+}
+
+// Run and manage the hex board game.
+template <class Board>
+Player GameRunner<Board>::run() {
+  vector<PlayerBase> players = { player1_, player2_ };
+  Row row;
+  Column column;
+  Result result;
+  Player winner;
+
+  while(!hex_board_.game_over()) {
+    for(auto& player: players) {
+      hex_board_.draw();
+      show_current_player_move(player);
+      result = get_player_move(player, row, column);
+
+      // Skip this player if there is no valid move.
+      if(!result.status)
+	continue;
+      result = add_player_move(player, row, column);
+
+      // Skip this player if there is a failure.
+      if(!result.status) {
+	cout << "Fail to add move from " << player.name()
+	     << " after " << MAX_ATTEMPTS << " attempts."  << endl; 
+	continue;
+      }
+      if(hex_board_.game_over())
+	break;
+      moves_++;
+    }
+  }
+  winner = hex_board_.winner();
+  cout << get_player_name(winner) << " wins!" << endl;
+  hex_board_.draw();
+  return winner;
+}
+
 #endif // HEX_GAME_H_
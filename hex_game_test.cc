@@ -117,6 +117,43 @@ TEST(position_test_suite, test_neighbors_inner_position) {
   check_position_in_set(position.neighbors(), neighbor_set);
 }
 
+TEST(hex_adjacency_test_suite, test_neighbors) {
+  // Neighbors match Position::neighbors() in order.
+  const uint32_t size = 5;
+  const HexAdjacency& adjacency = HexAdjacency::of_size(size);
+  EXPECT_EQ(size * size, adjacency.cells()) << "Wrong number of cells.";
+  for(Row row = 0; row < size; row++)
+    for(Column column = 0; column < size; column++) {
+      vector<Position> expect = Position(row, column, size).neighbors();
+      vector<Position> neighbors;
+      for(Vertex cell: adjacency.neighbors(row * size + column))
+	neighbors.push_back(Position(cell / size, cell % size));
+      EXPECT_TRUE(expect == neighbors)
+	<< "Neighbors are wrong for: " << Position(row, column);
+    }
+}
+
+TEST(hex_adjacency_test_suite, test_borders) {
+  const HexAdjacency& adjacency = HexAdjacency::of_size(3);
+  auto borders = [&](Vertex cell) {
+    HexAdjacency::VertexRange range = adjacency.borders(cell);
+    return vector<Vertex>(range.begin(), range.end());
+  };
+  EXPECT_TRUE(vector<Vertex>({ COMPUTER_NORTH_VERTEX,
+	  CONTESTANT_WEST_VERTEX }) == borders(0))
+    << "North-west corner is on two borders.";
+  EXPECT_TRUE(vector<Vertex>({ COMPUTER_SOUTH_VERTEX }) == borders(7))
+    << "(2, 1) is on the southern border.";
+  EXPECT_TRUE(borders(4).empty()) << "Center is on no border.";
+  EXPECT_EQ(4, HexAdjacency::of_size(1).borders(0).end() -
+	    HexAdjacency::of_size(1).borders(0).begin())
+    << "The cell of size 1 is on all borders.";
+  EXPECT_EQ(&adjacency, &HexAdjacency::of_size(3))
+    << "Boards of a size share the table.";
+  EXPECT_EQ(Player::COMPUTER, virtual_vertex_player(COMPUTER_SOUTH_VERTEX));
+  EXPECT_EQ(Player::CONTESTANT, virtual_vertex_player(CONTESTANT_WEST_VERTEX));
+}
+
 TEST(hex_board_test_suite, test_invalid_position) {
   HexBoard hb = HexBoard(7);
   Result expect = { false, INVALID_POSITION };
@@ -216,3 +253,41 @@ TEST(hex_board_test_suite, test_game_over_contestant_win1) {
   EXPECT_EQ(expect, hb.add_player_position(Player::COMPUTER, 0, 2))
       << "Hex board should return game over.";
 }
+
+TEST(hex_board_test_suite, test_make_unmake_move) {
+  HexBoard hb = HexBoard(4);
+  vector<Position> computer_positions = { Position(0, 0),
+					  Position(1, 0),
+					  Position(2, 0) };
+  for(size_t i = 0; i < computer_positions.size(); i++) {
+    EXPECT_EQ(SUCCESS_RESULT, hb.make_move(Player::COMPUTER,
+					   computer_positions[i].row(),
+					   computer_positions[i].column()))
+      << "Hex board should return success.";
+    EXPECT_EQ(SUCCESS_RESULT, hb.make_move(Player::CONTESTANT, i, 1))
+      << "Hex board should return success.";
+  }
+  EXPECT_EQ(SUCCESS_RESULT, hb.make_move(Player::COMPUTER, 3, 0));
+  EXPECT_EQ(Player::COMPUTER, hb.winner()) << "Computer should win.";
+
+  // Undoing the winning move reopens the game and the position.
+  hb.unmake_move();
+  EXPECT_EQ(Player::NONE, hb.winner()) << "Winner should be undone.";
+  EXPECT_FALSE(hb.game_over()) << "Game should not be over.";
+  Position position = Position(3, 0);
+  EXPECT_EQ(Player::NONE, hb.get_player(position))
+    << "Position should be free.";
+  EXPECT_EQ(SUCCESS_RESULT, hb.make_move(Player::COMPUTER, 3, 1));
+  EXPECT_EQ(Player::NONE, hb.winner())
+    << "Computer should not win without (1, 0) to (3, 0).";
+  hb.unmake_move();
+
+  // Undoing the column of the contestant lets it win along row 3.
+  for(int i = 0; i < 6; i++)
+    hb.unmake_move();
+  for(Column column = 0; column < 4; column++) {
+    EXPECT_EQ(SUCCESS_RESULT, hb.make_move(Player::CONTESTANT, 3, column))
+      << "Position should be free: " << column;
+  }
+  EXPECT_EQ(Player::CONTESTANT, hb.winner()) << "Contestant should win.";
+}
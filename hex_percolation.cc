@@ -0,0 +1,115 @@
+// Benchmark of site percolation on the hex lattice: estimate the
+// percolation threshold of a hex board from many trials run in parallel,
+// and measure the throughput of the union-find and lattice operations at
+// board sizes far beyond those of the game.
+
+#include "benchmark.h"
+#include "percolation.h"
+
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <string>
+
+namespace po = boost::program_options;
+
+using namespace std;
+
+// Command line options.
+struct Options {
+  // Benchmark report format.
+  ReportFormat format;
+  // Benchmark repetitions.
+  int repetitions;
+  // Seed of the trials.
+  unsigned seed;
+  // Hex board size.
+  int size;
+  // Number of worker threads.  0 uses all hardware threads.
+  int threads;
+  // Number of trials per repetition.
+  long trials;
+};
+
+// Parse command line arguments and return the options.
+Options parse_cmd_line(int argc, char* argv[]) {
+  Options options;
+  string format;
+
+  // Parse and handle command line options.
+  po::options_description desc("Allowed options");
+  desc.add_options()
+    ("help,h", "Produce help message.")
+    ("format", po::value<string>(&format)->default_value("json"),
+     "Benchmark report format: json or csv.")
+    ("repetitions,r",
+     po::value<int>(&options.repetitions)->default_value(3),
+     "Benchmark repetitions.")
+    ("seed,s", po::value<unsigned>(&options.seed)->default_value(1),
+     "Seed of the trials.")
+    ("size,n", po::value<int>(&options.size)->default_value(128),
+     "Hex board size.")
+    ("threads,t", po::value<int>(&options.threads)->default_value(0),
+     "Number of worker threads.  0 uses all hardware threads.")
+    ("trials,m", po::value<long>(&options.trials)->default_value(1000),
+     "Trials per repetition.");
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  // --help option.
+  if(vm.count("help")) {
+    cout << desc << endl;
+    exit(1);
+  }
+
+  // --format option.
+  if(!parse_report_format(format, options.format)) {
+    cout << "Unknown report format: " << format << endl;
+    exit(1);
+  }
+
+  // --size and --trials options.
+  if(options.size < 1 || options.trials < 1) {
+    cout << "Board size and trials must be positive." << endl;
+    exit(1);
+  }
+  if(options.repetitions < 1)
+    options.repetitions = 1;
+  return options;
+}
+
+// Main routine.  Every repetition runs the same trials, so the threshold
+// estimate is that of one repetition, while the timings of all of them
+// give the throughput.
+int main(int argc, char* argv[]) {
+  Options options = parse_cmd_line(argc, argv);
+  TimingStats timings;
+  PercolationStats stats;
+  long occupied = 0;
+
+  for(int i = 0; i < options.repetitions; i++) {
+    Stopwatch stopwatch = Stopwatch();
+    occupied = 0;
+    stats = run_percolation(options.size, options.trials, options.seed,
+			    options.threads, &occupied);
+    timings.add(stopwatch.elapsed());
+  }
+
+  BenchmarkReport report = BenchmarkReport("hex_percolation");
+  report.add_parameter("size", options.size);
+  report.add_parameter("trials", options.trials);
+  report.add_parameter("repetitions", options.repetitions);
+  report.add_parameter("seed", options.seed);
+  report.add_parameter("threads", options.threads);
+  report.add_parameter("threshold", stats.average());
+  report.add_parameter("confidence_interval", stats.confidence_interval());
+  report.add_parameter("min_threshold", stats.min());
+  report.add_parameter("max_threshold", stats.max());
+  report.add_parameter("trials_per_second",
+		       options.trials / timings.median());
+  report.add_parameter("cells_per_second", occupied / timings.median());
+  report.add_parameter("peak_rss_kb", peak_rss_kb());
+  report.add_phase("trials", timings);
+  report.write(cout, options.format);
+  return 0;
+}
@@ -2,22 +2,245 @@
 // Monte Carlo simulation that calculates average shortest paths
 // in a random graph.
 
+#include "benchmark.h"
+#include "graph_generators.h"
 #include "random_graph.h"
 
+#include <boost/program_options.hpp>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
 
 const double MAX_DISTANCE = 10.0;   // Maximum distance.
 const double MIN_DISTANCE = 1.0;    // Minimum distance.
+const int REPORT_BUFFER = 1 << 16;  // Bytes of report file buffer.
 const int TRIALS = 1000;            // Total trials.
 using namespace std;
 
+// Command line options.
+struct Options {
+  // Whether to solve trials in batches.
+  bool batched;
+  // Checkpoint file prefix, or empty if none.
+  string checkpoint;
+  // Trials between checkpoints.
+  int checkpoint_every;
+  // Average degree of the graph to write.
+  double degree;
+  // Output format: text, or a report format.
+  string format;
+  // Graph generator: gnp, gnm, ba, geometric or rmat.
+  string generator;
+  // Report file, or empty for stdout.
+  string report;
+  // Whether to redraw disconnected graphs.
+  bool resample;
+  // Whether to resume from the checkpoint files.
+  bool resume;
+  // Seed of the simulations.
+  unsigned seed;
+  // Whether to sweep the edge densities with coupled random graphs.
+  bool sweep;
+  // Target relative width of the confidence interval, or 0 if none.
+  double target_width;
+  // Number of worker threads.
+  int threads;
+  // Trials per edge density.
+  int trials;
+  // Number of vertices of the graph to write.
+  int vertices;
+  // Binary graph file to write instead of simulating, if any.
+  string write_graph;
+};
+
+// Parse command line arguments and return the options.
+Options parse_cmd_line(int argc, char* argv[]) {
+  Options options;
+
+  // Parse and handle command line options.
+  po::options_description desc("Allowed options");
+  desc.add_options()
+    ("batched,b", po::bool_switch(&options.batched),
+     "Solve trials in batches of graphs with lockstep Dijkstra.")
+    ("checkpoint,k", po::value<string>(&options.checkpoint),
+     "Write checkpoints to this file, with the index of the edge density "
+     "appended.")
+    ("checkpoint_every,e",
+     po::value<int>(&options.checkpoint_every)->default_value(100),
+     "Trials between checkpoints.")
+    ("degree,d", po::value<double>(&options.degree)->default_value(10.0),
+     "Average degree of the graph to write.")
+    ("format,f", po::value<string>(&options.format)->default_value("text"),
+     "Output format: text, json (one object per edge density) or csv "
+     "(one row per destination and edge density).")
+    ("generator,g",
+     po::value<string>(&options.generator)->default_value("gnp"),
+     "Graph generator: gnp, gnm, ba (Barabasi-Albert), geometric or "
+     "rmat.")
+    ("help,h", "Produce help message.")
+    ("report,p", po::value<string>(&options.report),
+     "Write json or csv output to this file instead of stdout.")
+    ("resample,r", po::bool_switch(&options.resample),
+     "Redraw disconnected graphs, so that all vertices are reachable.")
+    ("resume,u", po::bool_switch(&options.resume),
+     "Resume from existing checkpoint files.  Other options, including "
+     "the seed, must be the same as in the interrupted run.")
+    ("seed,s", po::value<unsigned>(&options.seed),
+     "Seed of the simulations.  Default is seeded from the clock.")
+    ("sweep,w", po::bool_switch(&options.sweep),
+     "Sweep all edge densities with one coupled G(n, p) graph per trial, "
+     "and print text.  Only trials, seed and threads apply.")
+    ("target_width,c",
+     po::value<double>(&options.target_width)->default_value(0.0),
+     "Stop once the 95% confidence interval of the average path distance "
+     "is narrower than this fraction of it, e.g. 0.01.  Trials is then "
+     "the maximum.  0 runs all trials.")
+    ("threads,t", po::value<int>(&options.threads)->default_value(0),
+     "Number of worker threads.  0 uses all hardware threads.")
+    ("trials,n", po::value<int>(&options.trials)->default_value(TRIALS),
+     "Trials per edge density.")
+    ("vertices,v", po::value<int>(&options.vertices)->default_value(1000000),
+     "Number of vertices of the graph to write.")
+    ("write_graph,o", po::value<string>(&options.write_graph),
+     "Write one generated graph to this binary graph file and exit.");
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  // --help option.
+  if(vm.count("help")) {
+    cout << desc << endl;
+    exit(1);
+  }
+
+  // --seed option.
+  if(!vm.count("seed"))
+    options.seed = clock_seed();
+
+  // --generator option.
+  if(!make_generator(options.generator, MAX_VERTICES, 0.0, MIN_DISTANCE,
+		     MAX_DISTANCE)) {
+    cout << "Unknown graph generator: " << options.generator << endl;
+    exit(1);
+  }
+
+  // --vertices option.  The edge density of the written graph divides by
+  // the number of other vertices.
+  if(!options.write_graph.empty() && options.vertices < 2) {
+    cout << "Number of vertices must be at least 2." << endl;
+    exit(1);
+  }
+
+  // --format option.
+  ReportFormat format;
+  if(options.format != "text" && !parse_report_format(options.format,
+						       format)) {
+    cout << "Unknown output format: " << options.format << endl;
+    exit(1);
+  }
+
+  // --sweep option.  The sweep couples G(n, p) graphs across all edge
+  // densities and prints text, so other options of a simulation would be
+  // ignored.
+  if(options.sweep &&
+     (options.generator != "gnp" || options.format != "text" ||
+      !options.report.empty() || !options.checkpoint.empty() ||
+      options.resume || options.target_width != 0.0 || options.resample ||
+      options.batched)) {
+    cout << "--sweep takes only the trials, seed and threads options."
+	 << endl;
+    exit(1);
+  }
+  return options;
+}
+
 // Main routine.
-int main() {
+int main(int argc, char* argv[]) {
+  Options options = parse_cmd_line(argc, argv);
   vector<double> edge_densities = { 0.2, 0.4 };
-  for(double density: edge_densities) {
-    Simulation sim = Simulation(density, MIN_DISTANCE, MAX_DISTANCE, TRIALS);
+  vector<char> buffer(REPORT_BUFFER);
+  ofstream report_file;
+  ostream* report = &cout;
+  ReportFormat format = ReportFormat::JSON;
+
+  // Write a large graph instance.
+  if(!options.write_graph.empty()) {
+    unique_ptr<GraphGenerator> generator =
+      make_generator(options.generator, options.vertices,
+		     options.degree / (options.vertices - 1), MIN_DISTANCE,
+		     MAX_DISTANCE);
+    Philox philox = Philox(options.seed);
+    BinaryGraphWriter writer(options.write_graph, options.vertices);
+    if(!writer.ok()) {
+      cout << "Unable to open graph file: " << options.write_graph << endl;
+      return 1;
+    }
+    generator->generate(philox, writer);
+    writer.close();
+    if(!writer.ok()) {
+      cout << "Unable to write graph file: " << options.write_graph << endl;
+      return 1;
+    }
+    cout << "Wrote " << writer.edges() << " edges to "
+	 << options.write_graph << endl;
+    return 0;
+  }
+  if(options.sweep) {
+    DensitySweep sweep = DensitySweep(edge_densities, MIN_DISTANCE,
+				      MAX_DISTANCE, options.trials,
+				      options.seed, options.threads);
+    sweep.run();
+    sweep.print();
+    return 0;
+  }
+
+  // Select report sink.  Reports are written through a large buffer and
+  // flushed once at the end.
+  if(options.format != "text") {
+    parse_report_format(options.format, format);
+    if(!options.report.empty()) {
+      report_file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+      report_file.open(options.report.c_str());
+      if(!report_file) {
+	cout << "Unable to open report file: " << options.report << endl;
+	return 1;
+      }
+      report = &report_file;
+    }
+    if(format == ReportFormat::CSV)
+      Simulation::write_csv_header(*report);
+  }
+  for(int i = 0; i < int(edge_densities.size()); i++) {
+    double density = edge_densities[i];
+    Simulation sim = Simulation(density, MIN_DISTANCE, MAX_DISTANCE,
+				options.trials, options.seed,
+				options.threads);
+    unique_ptr<GraphGenerator> generator =
+      make_generator(options.generator, MAX_VERTICES, density, MIN_DISTANCE,
+		     MAX_DISTANCE);
+    if(options.generator != "gnp")
+      sim.set_generator(generator.get());
+    sim.set_batched(options.batched);
+    sim.set_resample(options.resample);
+    sim.set_target_width(options.target_width);
+    if(!options.checkpoint.empty()) {
+      string filename = options.checkpoint + "." + to_string(i);
+      if(options.resume && ifstream(filename) && !sim.resume(filename)) {
+	cout << "Checkpoint does not match the options: " << filename << endl;
+	return 1;
+      }
+      sim.set_checkpoint(filename, options.checkpoint_every);
+    }
     sim.run();
-    sim.print();
+    if(options.format == "text")
+      sim.print();
+    else
+      sim.write_report(*report, format);
   }
+  report->flush();
   return 0;
 }
@@ -1,26 +1,67 @@
 // Homework 3
 // Implement Prim MST algorithm.
 
+#include "benchmark.h"
+#include "euclidean_mst.h"
 #include "prim.h"
 
 #include <boost/program_options.hpp>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace po = boost::program_options;
 using namespace std;
 
-// Parse command line arguments and return file name for input graph.
-string parse_cmd_line(int argc, char* argv[], bool& cost_only) {
+// Command line options.
+struct Options {
+  // MST algorithm: "prim" or "kruskal" for graph files; "euclidean" for
+  // point sets.
+  string algorithm;
+  // Run benchmark mode.
+  bool bench;
+  // Print MST cost only.
+  bool cost_only;
+  // Name of input file.
   string filename;
+  // Benchmark report format.
+  ReportFormat format;
+  // Benchmark repetitions.
+  int repetitions;
+  // Output sink: "stdout", "null" or name of output file.
+  string sink;
+};
+
+// Benchmark phases.
+enum Phase { PARSE, BUILD, MST, OUTPUT, TOTAL_PHASES };
+const string phase_name[] = { "parse", "build", "mst", "output" };
+
+// Parse command line arguments and return the options.
+Options parse_cmd_line(int argc, char* argv[]) {
+  Options options;
+  string format;
 
   // Parse and handle command line options.
   po::options_description desc("Allowed options");
   desc.add_options()
     ("help,h", "Produce help message.")
+    ("algorithm,a",
+     po::value<string>(&options.algorithm)->default_value("prim"),
+     "MST algorithm: prim or kruskal (graph file), or euclidean "
+     "(point-set file).")
+    ("bench,b", "Benchmark parse, build, MST and output phases.")
     ("cost_only,c", "Print MST cost only.")
-    ("file,f", po::value<string>(&filename), "Name of input graph file.");
+    ("file,f", po::value<string>(&options.filename),
+     "Name of input graph file.")
+    ("format", po::value<string>(&format)->default_value("json"),
+     "Benchmark report format: json or csv.")
+    ("repetitions,r",
+     po::value<int>(&options.repetitions)->default_value(10),
+     "Benchmark repetitions.")
+    ("sink,s", po::value<string>(&options.sink),
+     "MST output sink: stdout, null or name of output file.  Default is "
+     "stdout, or null in benchmark mode.");
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
   po::notify(vm);
@@ -30,33 +71,132 @@ string parse_cmd_line(int argc, char* argv[], bool& cost_only) {
     cout << desc << endl;
     exit(1);
   }
-  
+
   // --file option.
-  ifstream ifs(filename.c_str());
+  ifstream ifs(options.filename.c_str());
   if(!ifs) {
     cout << "Please provide name of input graph file." << endl;
     cout << desc << endl;
     exit(1);
   }
 
-  // --cost_only option.
-  cost_only = vm.count("cost_only");
-  return filename;
-} 
+  // --algorithm option.
+  if(options.algorithm != "prim" && options.algorithm != "kruskal" &&
+     options.algorithm != "euclidean") {
+    cout << "Unknown MST algorithm: " << options.algorithm << endl;
+    exit(1);
+  }
+
+  // --format option.
+  if(!parse_report_format(format, options.format)) {
+    cout << "Unknown report format: " << format << endl;
+    exit(1);
+  }
+
+  // --bench, --cost_only and --sink options.
+  options.bench = vm.count("bench");
+  options.cost_only = vm.count("cost_only");
+  if(options.sink.empty())
+    options.sink = options.bench ? "null" : "stdout";
+  if(options.repetitions < 1)
+    options.repetitions = 1;
+  return options;
+}
+
+// Compute MST for the input file and write it to the output sink.  The
+// elapsed time of each phase is added to the phase timing statistics.
+// Return MST cost.
+double run_mst(Options& options, ostream& out,
+	       vector<TimingStats>& phases) {
+  Stopwatch stopwatch = Stopwatch();
+  Graph mst;
+
+  if(options.algorithm == "euclidean") {
+
+    // Compute Euclidean MST for input point set.  The k-d tree is built
+    // within the MST phase.
+    PointSet point_set = PointSet(options.filename);
+    phases[PARSE].add(stopwatch.elapsed());
+    stopwatch.restart();
+    EuclideanMst emst = EuclideanMst(point_set);
+    mst = emst.mst();
+    phases[MST].add(stopwatch.elapsed());
+  } else if(options.algorithm == "kruskal") {
+
+    // Compute MST for input edges.  Kruskal needs no graph to be built.
+    vector<Edge> edges = Graph::read_edges(options.filename);
+    phases[PARSE].add(stopwatch.elapsed());
+    stopwatch.restart();
+    Kruskal kruskal = Kruskal(move(edges));
+    mst = kruskal.mst();
+    phases[MST].add(stopwatch.elapsed());
+  } else {
+
+    // Compute MST for input graph.
+    vector<Edge> edges = Graph::read_edges(options.filename);
+    phases[PARSE].add(stopwatch.elapsed());
+    stopwatch.restart();
+    Graph graph = Graph();
+    graph.add_edges(edges);
+    phases[BUILD].add(stopwatch.elapsed());
+    stopwatch.restart();
+    Prim prim = Prim(graph);
+    mst = prim.mst();
+    phases[MST].add(stopwatch.elapsed());
+  }
+
+  // Write MST to the output sink.
+  stopwatch.restart();
+  out << "MST cost: " << mst.edge_costs() << endl;
+  if(!options.cost_only)
+    mst.print_edges(out);
+  phases[OUTPUT].add(stopwatch.elapsed());
+  return mst.edge_costs();
+}
 
 // Main routine.
 int main(int argc, char* argv[]) {
-  bool cost_only = false;
-  string filename = parse_cmd_line(argc, argv, cost_only);
-  cout << "Input graph file: " << filename << endl;
-
-  // Compute MST for input graph.
-  Graph graph = Graph(filename);
-  Prim prim = Prim(graph);
-  Graph prim_mst = prim.mst();
-
-  cout << "MST cost: " << prim_mst.edge_costs() << endl;
-  if(!cost_only)
-    prim_mst.print_edges();
+  Options options = parse_cmd_line(argc, argv);
+  vector<TimingStats> phases(TOTAL_PHASES);
+  NullBuffer null_buffer;
+  ostream null_stream(&null_buffer);
+  ofstream file_stream;
+  ostream* out = &cout;
+  double cost = 0.0;
+
+  // Select output sink.
+  if(options.sink == "null") {
+    out = &null_stream;
+  } else if(options.sink != "stdout") {
+    file_stream.open(options.sink.c_str());
+    if(!file_stream) {
+      cout << "Unable to open output file: " << options.sink << endl;
+      return 1;
+    }
+    out = &file_stream;
+  }
+  if(!options.bench) {
+    if(options.algorithm == "euclidean")
+      cout << "Input point set file: " << options.filename << endl;
+    else
+      cout << "Input graph file: " << options.filename << endl;
+    run_mst(options, *out, phases);
+    return 0;
+  }
+
+  // Benchmark mode.
+  for(int i = 0; i < options.repetitions; i++)
+    cost = run_mst(options, *out, phases);
+  BenchmarkReport report = BenchmarkReport("hw3");
+  report.add_parameter("file", options.filename);
+  report.add_parameter("algorithm", options.algorithm);
+  report.add_parameter("sink", options.sink);
+  report.add_parameter("repetitions", options.repetitions);
+  report.add_parameter("mst_cost", cost);
+  report.add_parameter("peak_rss_kb", peak_rss_kb());
+  for(int phase = 0; phase < TOTAL_PHASES; phase++)
+    if(phases[phase].size())
+      report.add_phase(phase_name[phase], phases[phase]);
+  report.write(cout, options.format);
   return 0;
 }
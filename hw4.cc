@@ -60,7 +60,8 @@ int main() {
   HexBoard hb = HexBoard(BOARD_SIZE);
   PlayerBase computer = PlayerBase(Player::COMPUTER);
   PlayerBase contestant = PlayerBase(Player::CONTESTANT);
-  GameRunner runner = GameRunner(hb, computer, contestant);
+  GameRunner<HexBoard> runner = GameRunner<HexBoard>(hb, computer,
+						     contestant);
 
   print_header();
   runner.run();
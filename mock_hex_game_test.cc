@@ -19,7 +19,8 @@ TEST(game_runner_test_suite, test_computer_win1) {
     .Times(2)
     .WillOnce(Return(Position(0, 1)))
     .WillOnce(Return(Position(1, 1)));
-  GameRunner runner = GameRunner(hb, computer, contestant);
+  GameRunner<HexBoard> runner = GameRunner<HexBoard>(hb, computer,
+						     contestant);
   EXPECT_EQ(COMPUTER, runner.run());
 }
 
@@ -0,0 +1,196 @@
+// Homework 3
+// Implement MST verification and sensitivity analysis.
+
+#include "mst_verifier.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+const double NO_EDGE_COST = -numeric_limits<double>::infinity();
+
+// Return key of an edge for hash look-up.
+inline long long edge_key(int vertex1, int vertex2) {
+  return (static_cast<long long>(vertex1) << 32) |
+    static_cast<unsigned>(vertex2);
+}
+
+// =============
+//  MstVerifier
+// =============
+
+// Construct the verifier for the given graph and its spanning tree.
+MstVerifier::MstVerifier(Graph& graph, Graph& tree, int threads)
+  : levels_(1),
+    minimal_(true),
+    size_(0),
+    threads_(threads),
+    valid_tree_(true) {
+  vector<thread> workers;
+  int begin, chunk;
+
+  if(threads_ <= 0)
+    threads_ = max(1u, thread::hardware_concurrency());
+  for(int vertex: graph.get_vertices())
+    index(vertex);
+  for(int vertex: tree.get_vertices())
+    index(vertex);
+  check_tree_edges(graph, tree);
+  build_tables(tree);
+
+  // Answer path-maximum queries of non-tree edges in parallel.
+  sensitivities_.resize(non_tree_edges_.size());
+  chunk = (non_tree_edges_.size() + threads_ - 1) / threads_;
+  for(begin = 0; begin < int(non_tree_edges_.size()); begin += chunk)
+    workers.push_back(thread(&MstVerifier::compute_range, this, begin,
+			     min<int>(begin + chunk, non_tree_edges_.size())));
+  for(auto& worker: workers)
+    worker.join();
+
+  // Summarize the results.
+  for(auto& result: sensitivities_) {
+    if(!result.connected)
+      valid_tree_ = false;
+    else if(result.slack < 0)
+      minimal_ = false;
+  }
+}
+
+// Root every tree component and build the binary lifting tables.
+void MstVerifier::build_tables(Graph& tree) {
+  vector<vector<pair<int, double> > > adjacency(size_);
+  vector<int> queue;
+  int tree_edges = 0, components = 0;
+
+  for(auto& edge: tree.get_edges()) {
+    int index1 = index(edge.vertex1), index2 = index(edge.vertex2);
+    adjacency[index1].push_back(make_pair(index2, edge.cost));
+    adjacency[index2].push_back(make_pair(index1, edge.cost));
+    tree_edges++;
+  }
+  while((1 << levels_) < size_)
+    levels_++;
+  ancestors_.assign(levels_ * size_, 0);
+  maxima_.assign(levels_ * size_, NO_EDGE_COST);
+  components_.assign(size_, -1);
+  depths_.assign(size_, 0);
+
+  // Breadth-first search from the root of each component.  A root is
+  // its own ancestor.
+  queue.reserve(size_);
+  for(int root = 0; root < size_; root++) {
+    if(components_[root] >= 0)
+      continue;
+    components_[root] = components;
+    ancestors_[root] = root;
+    queue.push_back(root);
+    for(int head = queue.size() - 1; head < int(queue.size()); head++) {
+      int idx = queue[head];
+      for(auto& neighbor: adjacency[idx]) {
+	if(components_[neighbor.first] >= 0)
+	  continue;
+	components_[neighbor.first] = components;
+	depths_[neighbor.first] = depths_[idx] + 1;
+	ancestors_[neighbor.first] = idx;
+	maxima_[neighbor.first] = neighbor.second;
+	queue.push_back(neighbor.first);
+      }
+    }
+    components++;
+  }
+
+  // A forest has exactly one edge less than vertices per component.
+  if(tree_edges != size_ - components)
+    valid_tree_ = false;
+
+  // Build upper levels from lower ones.
+  for(int level = 1; level < levels_; level++)
+    for(int idx = 0; idx < size_; idx++) {
+      int middle = ancestor(level - 1, idx);
+      ancestors_[level*size_ + idx] = ancestor(level - 1, middle);
+      maxima_[level*size_ + idx] = max(maximum(level - 1, idx),
+				       maximum(level - 1, middle));
+    }
+}
+
+// Check tree edges against the graph and collect non-tree edges.
+void MstVerifier::check_tree_edges(Graph& graph, Graph& tree) {
+  unordered_map<long long, double> tree_costs;
+  int matched = 0;
+
+  for(auto& edge: tree.get_edges())
+    tree_costs.emplace(edge_key(edge.vertex1, edge.vertex2), edge.cost);
+  for(auto& edge: graph.get_edges()) {
+    auto it = tree_costs.find(edge_key(edge.vertex1, edge.vertex2));
+    if(it == tree_costs.end()) {
+      non_tree_edges_.push_back(edge);
+      continue;
+    }
+    if(it->second == edge.cost)
+      matched++;
+  }
+
+  // Every tree edge must be a graph edge with the same cost.
+  if(matched != int(tree_costs.size()))
+    valid_tree_ = false;
+}
+
+// Compute sensitivities of non-tree edges in [begin, end).
+void MstVerifier::compute_range(int begin, int end) {
+  for(int i = begin; i < end; i++) {
+    const Edge& edge = non_tree_edges_[i];
+    EdgeSensitivity& result = sensitivities_[i];
+    auto index1 = vertex_index_.find(edge.vertex1);
+    auto index2 = vertex_index_.find(edge.vertex2);
+
+    result.edge = edge;
+    result.path_max = path_max(index1->second, index2->second,
+			       result.connected);
+    result.slack = edge.cost - result.path_max;
+  }
+}
+
+// Return dense index of a vertex.
+int MstVerifier::index(int vertex) {
+  auto it = vertex_index_.find(vertex);
+  if(it != vertex_index_.end())
+    return it->second;
+  vertex_index_.emplace(vertex, size_);
+  return size_++;
+}
+
+// Return maximum tree edge cost on the path between two indices.
+double MstVerifier::path_max(int index1, int index2, bool& connected) const {
+  double result = NO_EDGE_COST;
+
+  connected = components_[index1] == components_[index2];
+  if(!connected)
+    return result;
+
+  // Lift the deeper index to the same depth.
+  if(depths_[index1] < depths_[index2])
+    swap(index1, index2);
+  for(int level = levels_ - 1; level >= 0; level--)
+    if(depths_[index1] - (1 << level) >= depths_[index2]) {
+      result = max(result, maximum(level, index1));
+      index1 = ancestor(level, index1);
+    }
+  if(index1 == index2)
+    return result;
+
+  // Lift both indices to just below their lowest common ancestor.
+  for(int level = levels_ - 1; level >= 0; level--)
+    if(ancestor(level, index1) != ancestor(level, index2)) {
+      result = max(result, max(maximum(level, index1),
+			       maximum(level, index2)));
+      index1 = ancestor(level, index1);
+      index2 = ancestor(level, index2);
+    }
+  return max(result, max(maximum(0, index1), maximum(0, index2)));
+}
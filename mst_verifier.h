@@ -0,0 +1,93 @@
+// Header file for MST verification and sensitivity analysis.
+
+#ifndef MST_VERIFIER_H_
+#define MST_VERIFIER_H_
+
+#include "prim.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Sensitivity of a non-tree edge.  Path maximum is the largest edge cost
+// on the tree path between the edge's vertices.  Slack is the amount by
+// which the edge cost can drop before the edge would replace a tree
+// edge, i.e. edge cost minus path maximum.  A negative slack means the
+// tree is not minimal.
+struct EdgeSensitivity {
+  Edge edge;
+  // False if the edge's vertices are not connected by the tree.
+  bool connected;
+  double path_max;
+  double slack;
+};
+
+// A class to verify that a spanning tree is an MST of a graph and to
+// compute the sensitivity of all non-tree edges.  The tree is
+// preprocessed by binary lifting, which stores for every vertex its
+// 2^k-th ancestor and the maximum edge cost on the way up.  The path
+// maximum of each non-tree edge is then answered in O(log V), and the
+// non-tree edges are split across threads since queries are read-only.
+class MstVerifier {
+ public:
+  // Construct the verifier for the given graph and its spanning tree.
+  // If threads is 0, use the number of hardware threads.
+  MstVerifier(Graph& graph, Graph& tree, int threads=0);
+  // Return sensitivities of all non-tree edges ordered as in
+  // Graph::get_edges().
+  vector<EdgeSensitivity> sensitivity() { return sensitivities_; }
+  // Verify that the tree is an MST of the graph: all tree edges belong
+  // to the graph with the same costs, the tree spans every vertex
+  // connected in the graph, and no non-tree edge is cheaper than the
+  // tree path it would close.
+  bool verify() const { return valid_tree_ && minimal_; }
+
+ private:
+  // Root every tree component and build the binary lifting tables.
+  void build_tables(Graph& tree);
+  // Check tree edges against the graph and collect non-tree edges.
+  void check_tree_edges(Graph& graph, Graph& tree);
+  // Compute sensitivities of non-tree edges in [begin, end).
+  void compute_range(int begin, int end);
+  // Return dense index of a vertex.  Add the vertex if needed.
+  int index(int vertex);
+  // Return maximum tree edge cost on the path between two indices.
+  // Set connected to false if they are in different tree components.
+  double path_max(int index1, int index2, bool& connected) const;
+  // Return the 2^level-th ancestor of the given index.
+  int ancestor(int level, int idx) const {
+    return ancestors_[level*size_ + idx];
+  }
+  // Return the maximum edge cost up to the 2^level-th ancestor of the
+  // given index.
+  double maximum(int level, int idx) const {
+    return maxima_[level*size_ + idx];
+  }
+  // 2^k-th ancestors of each index, level by level.
+  vector<int> ancestors_;
+  // Tree component of each index.
+  vector<int> components_;
+  // Depth of each index in its tree component.
+  vector<int> depths_;
+  // Number of binary lifting levels.
+  int levels_;
+  // Maximum edge costs up to the 2^k-th ancestors, level by level.
+  vector<double> maxima_;
+  // True if no non-tree edge is cheaper than its tree path.
+  bool minimal_;
+  // Non-tree edges of the graph.
+  vector<Edge> non_tree_edges_;
+  // Sensitivities of non-tree edges.
+  vector<EdgeSensitivity> sensitivities_;
+  // Number of vertices.
+  int size_;
+  // Number of threads.
+  int threads_;
+  // True if the tree is a spanning forest made of graph edges.
+  bool valid_tree_;
+  // Mapping of vertex to dense index.
+  unordered_map<int, int> vertex_index_;
+};
+
+#endif // MST_VERIFIER_H_
@@ -0,0 +1,111 @@
+// Unit tests for MST verification and sensitivity analysis using
+// Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "mst_verifier.h"
+#include "prim.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Sample graph from prim_test_suite.test_sample2.
+Graph sample_graph() {
+  Graph graph = Graph();
+  graph.add_edge(1, 2, 2);
+  graph.add_edge(1, 4, 4);
+  graph.add_edge(2, 3, 4);
+  graph.add_edge(2, 4, 4);
+  graph.add_edge(2, 5, 3);
+  graph.add_edge(2, 6, 1);
+  graph.add_edge(3, 6, 5);
+  graph.add_edge(4, 5, 2);
+  graph.add_edge(6, 5, 5);
+  return graph;
+}
+
+TEST(mst_verifier_test_suite, test_prim_mst) {
+  Graph graph = sample_graph();
+  Prim prim = Prim(graph);
+  Graph mst = prim.mst();
+  MstVerifier verifier = MstVerifier(graph, mst);
+  EXPECT_TRUE(verifier.verify()) << "Prim MST should be verified.";
+  EXPECT_EQ(4, verifier.sensitivity().size())
+    << "There should be 4 non-tree edges.";
+}
+
+TEST(mst_verifier_test_suite, test_sensitivity) {
+  Graph graph = sample_graph();
+  Graph mst = Graph();
+  mst.add_edge(1, 2, 2);
+  mst.add_edge(2, 6, 1);
+  mst.add_edge(2, 5, 3);
+  mst.add_edge(4, 5, 2);
+  mst.add_edge(2, 3, 4);
+  MstVerifier verifier = MstVerifier(graph, mst);
+  EXPECT_TRUE(verifier.verify()) << "Tree should be verified.";
+  for(auto& result: verifier.sensitivity()) {
+    EXPECT_TRUE(result.connected) << "Tree should span the graph.";
+    if(result.edge.vertex1 == 1 && result.edge.vertex2 == 4) {
+      EXPECT_EQ(3, result.path_max) << "Path max. of (1, 4) should be 3.";
+      EXPECT_EQ(1, result.slack) << "Slack of (1, 4) should be 1.";
+    }
+    if(result.edge.vertex1 == 3 && result.edge.vertex2 == 6) {
+      EXPECT_EQ(4, result.path_max) << "Path max. of (3, 6) should be 4.";
+      EXPECT_EQ(1, result.slack) << "Slack of (3, 6) should be 1.";
+    }
+  }
+}
+
+TEST(mst_verifier_test_suite, test_non_minimal_tree) {
+  Graph graph = sample_graph();
+  Graph tree = Graph();
+  tree.add_edge(1, 2, 2);
+  tree.add_edge(1, 4, 4);
+  tree.add_edge(2, 3, 4);
+  tree.add_edge(2, 5, 3);
+  tree.add_edge(2, 6, 1);
+  MstVerifier verifier = MstVerifier(graph, tree);
+  EXPECT_FALSE(verifier.verify()) << "Tree should not be minimal.";
+}
+
+TEST(mst_verifier_test_suite, test_not_spanning_tree) {
+  Graph graph = sample_graph();
+  Graph tree = Graph();
+  tree.add_edge(1, 2, 2);
+  tree.add_edge(2, 6, 1);
+  MstVerifier verifier = MstVerifier(graph, tree);
+  EXPECT_FALSE(verifier.verify()) << "Tree should not span the graph.";
+}
+
+TEST(mst_verifier_test_suite, test_foreign_tree_edge) {
+  Graph graph = sample_graph();
+  Graph tree = Graph();
+  tree.add_edge(1, 2, 2);
+  tree.add_edge(2, 6, 1);
+  tree.add_edge(2, 5, 3);
+  tree.add_edge(4, 5, 2);
+  tree.add_edge(3, 4, 1);
+  MstVerifier verifier = MstVerifier(graph, tree);
+  EXPECT_FALSE(verifier.verify())
+    << "Tree with an edge outside of the graph should fail.";
+}
+
+TEST(mst_verifier_test_suite, test_random_graphs) {
+  default_random_engine generator(1);
+  uniform_real_distribution<double> distribution(0.0, 1.0);
+  for(int threads = 1; threads <= 4; threads++) {
+    Graph graph = Graph();
+    for(int i = 0; i < 100; i++)
+      for(int j = i + 1; j < 100; j++)
+	if(distribution(generator) < 0.2 || j == i + 1)
+	  graph.add_edge(i, j, distribution(generator));
+    Prim prim = Prim(graph);
+    Graph mst = prim.mst();
+    MstVerifier verifier = MstVerifier(graph, mst, threads);
+    EXPECT_TRUE(verifier.verify())
+      << "Prim MST should be verified with threads: " << threads;
+  }
+}
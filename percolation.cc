@@ -0,0 +1,109 @@
+// Implement site percolation on the hex lattice.
+
+#include "percolation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ================
+//  HexPercolation
+// ================
+
+// Construct the percolation engine for a board of the given size.
+HexPercolation::HexPercolation(uint32_t size)
+  : occupied_(size * size, false),
+    order_(size * size),
+    size_(size),
+    union_find_(UnionFind(size * size)) {}
+
+// Occupy the given cell and join it with its occupied neighbors.  A cell
+// of a board of size 1 is on both borders.
+void HexPercolation::occupy(uint32_t cell) {
+  long row = cell / size_, column = cell % size_;
+  long neighbor_row, neighbor_column;
+
+  occupied_[cell] = true;
+  for(auto& delta: NEIGHBOR_DELTAS) {
+    neighbor_row = row + delta.row;
+    neighbor_column = column + delta.column;
+    if(neighbor_row < 0 || neighbor_row >= size_ ||
+       neighbor_column < 0 || neighbor_column >= size_)
+      continue;
+    Vertex neighbor = neighbor_row * size_ + neighbor_column;
+    if(occupied_[neighbor])
+      union_find_.join(neighbor, cell);
+  }
+  if(row == 0)
+    union_find_.join(COMPUTER_NORTH_VERTEX, cell);
+  if(row == size_ - 1)
+    union_find_.join(COMPUTER_SOUTH_VERTEX, cell);
+}
+
+// Run a trial.  The shuffle starts from the cells in order, so a trial
+// depends on the generator only.  The random index below the remaining
+// cells takes the high word of a 32-bit output times their number, whose
+// bias is below cells / 2^32.
+uint32_t HexPercolation::trial(Philox& generator) {
+  uint32_t count = order_.size();
+
+  for(uint32_t cell = 0; cell < count; cell++)
+    order_[cell] = cell;
+  fill(occupied_.begin(), occupied_.end(), false);
+  union_find_.clear();
+  for(uint32_t i = 0; i < count; i++) {
+    uint32_t j = i + (static_cast<uint64_t>(generator()) * (count - i) >> 32);
+    swap(order_[i], order_[j]);
+    occupy(order_[i]);
+    if(union_find_.find(COMPUTER_NORTH_VERTEX) ==
+       union_find_.find(COMPUTER_SOUTH_VERTEX))
+      return i + 1;
+  }
+
+  // A full board always spans, so this should not occur.
+  assert(false);
+  return count;
+}
+
+// Run trials in parallel.  Threads take chunks of PERCOLATION_CHUNK
+// trials from a shared counter and store the occupied cells per trial,
+// which are added to the statistics in trial order afterwards.
+PercolationStats run_percolation(uint32_t size, long trials, uint64_t seed,
+				 int threads, long* occupied) {
+  vector<uint32_t> results(trials);
+  atomic<long> next(0);
+  vector<thread> workers;
+  PercolationStats stats;
+  auto work = [&]() {
+    HexPercolation percolation = HexPercolation(size);
+    long begin;
+    while((begin = next.fetch_add(PERCOLATION_CHUNK)) < trials)
+      for(long trial = begin;
+	  trial < min(begin + PERCOLATION_CHUNK, trials); trial++) {
+	Philox generator = Philox(seed, trial);
+	results[trial] = percolation.trial(generator);
+      }
+  };
+
+  if(threads <= 0)
+    threads = max(1u, thread::hardware_concurrency());
+  threads = min<long>(threads,
+		      (trials + PERCOLATION_CHUNK - 1) / PERCOLATION_CHUNK);
+  if(threads <= 1) {
+    work();
+  } else {
+    for(int i = 0; i < threads; i++)
+      workers.push_back(thread(work));
+    for(auto& worker: workers)
+      worker.join();
+  }
+  for(uint32_t cells: results) {
+    stats.add(static_cast<double>(cells) / (size * size));
+    if(occupied)
+      *occupied += cells;
+  }
+  return stats;
+}
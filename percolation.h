@@ -0,0 +1,119 @@
+// Header file for site percolation on the hex lattice.
+
+#ifndef PERCOLATION_H_
+#define PERCOLATION_H_
+
+#include "hex_game.h"
+#include "philox.h"
+#include "union_find.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+const int PERCOLATION_CHUNK = 16;  // Trials per task of a parallel run.
+
+// Statistics of the percolation thresholds of trials, i.e. the fraction
+// of occupied cells at which the lattice first spans.
+class PercolationStats {
+ public:
+  // Construct a statistics instance.
+  PercolationStats()
+    : m2_(0.0), max_(0.0), mean_(0.0), min_(1.0), total_(0) {}
+  // Add threshold data point.
+  void add(double threshold) {
+    double delta = threshold - mean_;
+    total_++;
+    mean_ += delta / total_;
+    m2_ += delta * (threshold - mean_);
+    max_ = std::max(max_, threshold);
+    min_ = std::min(min_, threshold);
+  }
+  // Compute average.
+  double average() const { return mean_; }
+  // Return half width of the 95% confidence interval of the average,
+  // using the normal approximation.
+  double confidence_interval() const {
+    if(total_ < 2)
+      return 0.0;
+    return 1.96 * sqrt(variance() / total_);
+  }
+  // Return largest threshold.
+  double max() const { return max_; }
+  // Return smallest threshold.
+  double min() const { return min_; }
+  // Return total number of threshold data points.
+  long size() const { return total_; }
+  // Return sample variance.
+  double variance() const {
+    if(total_ < 2)
+      return 0.0;
+    return m2_ / (total_ - 1);
+  }
+
+ private:
+  // Sum of squared deviations from the mean.
+  double m2_;
+  // Largest threshold.
+  double max_;
+  // Running mean.
+  double mean_;
+  // Smallest threshold.
+  double min_;
+  // Total number of data points.
+  long total_;
+};
+
+// Site percolation on the hex lattice of HexBoard.  A trial occupies the
+// cells of an empty board in uniformly random order and stops as soon as
+// the occupied cells connect the northern and southern borders, as the
+// computer would win on HexBoard.  Cells join their occupied neighbors
+// in UnionFind, and border cells join the virtual vertices
+// COMPUTER_NORTH_VERTEX and COMPUTER_SOUTH_VERTEX, so spanning is one
+// comparison of roots per cell.  The order is drawn by a Fisher-Yates
+// shuffle one cell at a time, so the random numbers drawn are in
+// proportion to the cells a trial occupies.
+//
+// The threshold of the triangular lattice is 1/2.  On a board of n
+// cells, k occupied cells span north-south exactly when the n - k others
+// do not span east-west, as in Hex, so the number of cells at spanning
+// is distributed as n + 1 minus itself, with mean (n + 1) / 2 at every
+// size, while its spread narrows as the board grows.
+class HexPercolation {
+ public:
+  // Construct the percolation engine for a board of the given size.
+  explicit HexPercolation(uint32_t size);
+  // Return the number of cells.
+  uint32_t cells() const { return order_.size(); }
+  // Return board size.
+  uint32_t size() const { return size_; }
+  // Run a trial with random numbers from the generator.  Return the
+  // number of cells occupied when the borders first connect.
+  uint32_t trial(Philox& generator);
+
+ private:
+  // Occupy the given cell and join it with its occupied neighbors and
+  // its borders.
+  void occupy(uint32_t cell);
+  // Occupied flag of each cell.
+  vector<char> occupied_;
+  // Cells in the order of the current trial.
+  vector<uint32_t> order_;
+  // Board size.
+  uint32_t size_;
+  // Union-find over the cells and the virtual border vertices.
+  UnionFind union_find_;
+};
+
+// Run the given number of trials on a board of the given size, on the
+// given number of threads, or on all hardware threads for 0.  Trial i
+// draws from Philox stream i of the seed, so the result does not depend
+// on the number of threads.  Add the cells occupied by all trials to
+// occupied, if given.
+PercolationStats run_percolation(uint32_t size, long trials, uint64_t seed,
+				 int threads=0, long* occupied=nullptr);
+
+#endif // PERCOLATION_H_
@@ -0,0 +1,76 @@
+// Unit tests for site percolation on the hex lattice using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "hex_game.h"
+#include "percolation.h"
+#include "philox.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+TEST(percolation_test_suite, test_small_boards) {
+  HexPercolation single = HexPercolation(1);
+  Philox generator = Philox(3);
+  EXPECT_EQ(1, single.trial(generator)) << "One cell should span.";
+
+  // Both cells of a column of a 2x2 board span, and so do the cells
+  // (0, 1) and (1, 0), so 2 or 3 cells are occupied at spanning.
+  HexPercolation board = HexPercolation(2);
+  EXPECT_EQ(4, board.cells()) << "Cell count is wrong.";
+  long counts[5] = { 0 };
+  for(int i = 0; i < 6000; i++)
+    counts[board.trial(generator)]++;
+  EXPECT_EQ(0, counts[1] + counts[4]) << "Spanning needs 2 or 3 cells.";
+
+  // Three of the six pairs span, so half the trials take 2 cells.
+  EXPECT_NEAR(3000, counts[2], 200) << "Half should span with 2 cells.";
+}
+
+TEST(percolation_test_suite, test_matches_hex_board) {
+  // Replay the shuffle of a fresh engine on HexBoard, which must find the
+  // computer winning at the same move.
+  const uint32_t size = 9;
+  for(int stream = 0; stream < 50; stream++) {
+    HexPercolation percolation = HexPercolation(size);
+    Philox generator1 = Philox(11, stream), generator2 = Philox(11, stream);
+    uint32_t expect = percolation.trial(generator1);
+    vector<uint32_t> order(size * size);
+    for(uint32_t cell = 0; cell < order.size(); cell++)
+      order[cell] = cell;
+    HexBoard board = HexBoard(size);
+    uint32_t moves = 0;
+    while(board.winner() == Player::NONE) {
+      uint32_t j = moves + (static_cast<uint64_t>(generator2()) *
+			    (order.size() - moves) >> 32);
+      swap(order[moves], order[j]);
+      board.add_player_position(Player::COMPUTER, order[moves] / size,
+				order[moves] % size);
+      moves++;
+    }
+    EXPECT_EQ(Player::COMPUTER, board.winner()) << "Computer should win.";
+    EXPECT_EQ(moves, expect) << "Spanning move is wrong for stream: "
+			     << stream;
+  }
+}
+
+TEST(percolation_test_suite, test_run_percolation) {
+  // The mean cells at spanning is (n + 1) / 2 on a board of n cells.
+  const uint32_t size = 32;
+  const double expect = (size * size + 1) / (2.0 * size * size);
+  long occupied1 = 0, occupied4 = 0;
+  PercolationStats stats1 = run_percolation(size, 2000, 5, 1, &occupied1);
+  PercolationStats stats4 = run_percolation(size, 2000, 5, 4, &occupied4);
+  EXPECT_EQ(2000, stats1.size()) << "Trial count is wrong.";
+  EXPECT_EQ(stats1.average(), stats4.average())
+    << "Result should not depend on threads.";
+  EXPECT_EQ(occupied1, occupied4) << "Occupied cells should match.";
+  EXPECT_NEAR(expect, stats1.average(), 2 * stats1.confidence_interval())
+    << "Mean threshold is off.";
+  EXPECT_TRUE(stats1.min() < expect && expect < stats1.max())
+    << "Thresholds should spread around the mean.";
+  EXPECT_NEAR(stats1.average() * 2000 * size * size, occupied1, 1e-3)
+    << "Occupied cells should add up.";
+}
@@ -0,0 +1,80 @@
+// Implement Philox counter-based random number generator.
+
+#include "philox.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace std;
+
+const int PHILOX_ROUNDS = 10;               // Rounds per block.
+const uint32_t PHILOX_M0 = 0xD2511F53;      // Round multipliers.
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;      // Key schedule increments.
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+const double TWO_POW_MINUS_53 = 1.0 / 9007199254740992.0;
+
+// ========
+//  Philox
+// ========
+
+// Compute an output block from the given counter and key.
+PhiloxCounter Philox::block(PhiloxCounter counter, PhiloxKey key) {
+  uint64_t product0, product1;
+
+  for(int round = 0; round < PHILOX_ROUNDS; round++) {
+    if(round) {
+      key[0] += PHILOX_W0;
+      key[1] += PHILOX_W1;
+    }
+    product0 = static_cast<uint64_t>(PHILOX_M0) * counter[0];
+    product1 = static_cast<uint64_t>(PHILOX_M1) * counter[2];
+    counter = { static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+		static_cast<uint32_t>(product1),
+		static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+		static_cast<uint32_t>(product0) };
+  }
+  return counter;
+}
+
+// Skip the given number of 32-bit outputs.
+void Philox::discard(unsigned long long outputs) {
+  seek(tell() + outputs);
+}
+
+// Fill the array with uniform doubles in [low, high).
+void Philox::fill_uniform(double* out, size_t size, double low,
+			  double high) {
+  double scale = (high - low) * TWO_POW_MINUS_53;
+  PhiloxCounter words;
+  uint64_t bits;
+  size_t i = 0;
+
+  // Use up the current block, dropping an odd output, so that whole
+  // blocks can then be generated without the output buffer.
+  if(buffer_index_ % 2)
+    (*this)();
+  for(; i < size && buffer_index_ < WORDS; i++)
+    out[i] = low + (next_bits() >> 11) * scale;
+
+  // Each block yields two doubles.
+  for(; i + 1 < size; i += 2) {
+    words = block(counter(position_++), key_);
+    bits = (static_cast<uint64_t>(words[0]) << 32) | words[1];
+    out[i] = low + (bits >> 11) * scale;
+    bits = (static_cast<uint64_t>(words[2]) << 32) | words[3];
+    out[i + 1] = low + (bits >> 11) * scale;
+  }
+  if(i < size)
+    out[i] = low + (next_bits() >> 11) * scale;
+}
+
+// Move to the given number of 32-bit outputs since the stream start.
+void Philox::seek(unsigned long long outputs) {
+  position_ = outputs / WORDS;
+  buffer_index_ = WORDS;
+  if(outputs % WORDS) {
+    buffer_ = block(counter(position_++), key_);
+    buffer_index_ = outputs % WORDS;
+  }
+}
@@ -0,0 +1,94 @@
+// Header file for Philox counter-based random number generator.
+
+#ifndef PHILOX_H_
+#define PHILOX_H_
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace std;
+
+typedef array<uint32_t, 4> PhiloxCounter;  // Philox counter block.
+typedef array<uint32_t, 2> PhiloxKey;      // Philox key.
+
+// Philox4x32-10 counter-based random number generator (Salmon et al.,
+// Parallel random numbers: as easy as 1, 2, 3, SC 2011).  Each output
+// block of four 32-bit words is a keyed bijection of a 128-bit counter,
+// so any output can be computed directly from its address:
+// - seed: the key, shared by all streams of a run.
+// - stream: the upper 64 bits of the counter, e.g. one per trial.
+// - position: the lower 64 bits of the counter, counting blocks.
+// The class satisfies the uniform random bit generator requirements, so
+// it works with <random> distributions and algorithms such as shuffle.
+// fill_uniform() generates whole arrays of uniforms at once, which is
+// faster than drawing them one by one through a distribution.
+class Philox {
+ public:
+  typedef uint32_t result_type;
+  // Construct the generator for the given seed and stream.
+  Philox(uint64_t seed=0, uint64_t stream=0)
+    : buffer_({}),
+      buffer_index_(WORDS),
+      key_({ static_cast<uint32_t>(seed),
+	     static_cast<uint32_t>(seed >> 32) }),
+      position_(0),
+      stream_(stream) {}
+  // Return the smallest possible output.
+  static constexpr result_type min() { return 0; }
+  // Return the largest possible output.
+  static constexpr result_type max() { return 0xffffffff; }
+  // Return the next 32-bit output.
+  result_type operator()() {
+    if(buffer_index_ == WORDS) {
+      buffer_ = block(counter(position_++), key_);
+      buffer_index_ = 0;
+    }
+    return buffer_[buffer_index_++];
+  }
+  // Compute an output block from the given counter and key.
+  static PhiloxCounter block(PhiloxCounter counter, PhiloxKey key);
+  // Skip the given number of 32-bit outputs.
+  void discard(unsigned long long outputs);
+  // Fill the array with uniform doubles in [low, high).  Each double
+  // uses 53 random bits from two 32-bit outputs.
+  void fill_uniform(double* out, size_t size, double low=0.0,
+		    double high=1.0);
+  // Return the stream of the generator.
+  uint64_t stream() const { return stream_; }
+  // Return the number of 32-bit outputs generated so far.
+  unsigned long long tell() const {
+    return position_ * WORDS - (WORDS - buffer_index_);
+  }
+  // Move to the given number of 32-bit outputs since the stream start.
+  void seek(unsigned long long outputs);
+
+ private:
+  // 32-bit words per block.
+  static const int WORDS = 4;
+  // Return the counter of the given block position within the stream.
+  PhiloxCounter counter(uint64_t position) const {
+    PhiloxCounter result = { static_cast<uint32_t>(position),
+			     static_cast<uint32_t>(position >> 32),
+			     static_cast<uint32_t>(stream_),
+			     static_cast<uint32_t>(stream_ >> 32) };
+    return result;
+  }
+  // Current output block.
+  PhiloxCounter buffer_;
+  // Return the next 64 bits from two 32-bit outputs.
+  uint64_t next_bits() {
+    uint64_t high = (*this)();
+    return (high << 32) | (*this)();
+  }
+  // Index of next output within the current block.
+  int buffer_index_;
+  // Key derived from the seed.
+  PhiloxKey key_;
+  // Position of the next block within the stream.
+  uint64_t position_;
+  // Stream identifier.
+  uint64_t stream_;
+};
+
+#endif // PHILOX_H_
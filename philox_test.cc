@@ -0,0 +1,99 @@
+// Unit tests for Philox counter-based random number generator using
+// Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "philox.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+TEST(philox_test_suite, test_known_answers) {
+  // Known-answer vectors of Philox4x32-10 from Random123.
+  PhiloxCounter counter = { 0, 0, 0, 0 };
+  PhiloxKey key = { 0, 0 };
+  PhiloxCounter expect = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+  EXPECT_TRUE(expect == Philox::block(counter, key))
+    << "Block of zero counter and key is wrong.";
+  counter = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+  key = { 0xffffffff, 0xffffffff };
+  expect = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+  EXPECT_TRUE(expect == Philox::block(counter, key))
+    << "Block of all-ones counter and key is wrong.";
+  counter = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  key = { 0xa4093822, 0x299f31d0 };
+  expect = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+  EXPECT_TRUE(expect == Philox::block(counter, key))
+    << "Block of pi digits counter and key is wrong.";
+}
+
+TEST(philox_test_suite, test_seek_and_discard) {
+  Philox philox1 = Philox(5, 3);
+  vector<uint32_t> outputs;
+  for(int i = 0; i < 20; i++)
+    outputs.push_back(philox1());
+  EXPECT_EQ(20, philox1.tell()) << "Position should be 20.";
+  for(int start = 0; start < 20; start++) {
+    Philox philox2 = Philox(5, 3);
+    philox2.discard(start);
+    EXPECT_EQ(outputs[start], philox2())
+      << "Output after discard is wrong at: " << start;
+  }
+  philox1.seek(7);
+  EXPECT_EQ(outputs[7], philox1()) << "Output after seek is wrong.";
+}
+
+TEST(philox_test_suite, test_independent_streams) {
+  Philox philox1 = Philox(5, 0);
+  Philox philox2 = Philox(5, 1);
+  Philox philox3 = Philox(6, 0);
+  int same_stream = 0, same_seed = 0;
+  for(int i = 0; i < 100; i++) {
+    uint32_t output = philox1();
+    same_stream += output == philox2();
+    same_seed += output == philox3();
+  }
+  EXPECT_EQ(0, same_stream) << "Streams should differ.";
+  EXPECT_EQ(0, same_seed) << "Seeds should differ.";
+}
+
+TEST(philox_test_suite, test_fill_uniform) {
+  const int size = 1001;
+  vector<double> values(size);
+  Philox philox1 = Philox(9, 2);
+  Philox philox2 = Philox(9, 2);
+  double total = 0.0;
+
+  // A pending odd output must not change the rest of the batch.
+  philox1();
+  philox1.fill_uniform(values.data(), size, 1.0, 10.0);
+  for(double value: values) {
+    EXPECT_LE(1.0, value) << "Value should be at least 1.";
+    EXPECT_LT(value, 10.0) << "Value should be less than 10.";
+    total += value;
+  }
+  EXPECT_NEAR(5.5, total / size, 0.3) << "Mean should be close to 5.5.";
+
+  // Batches are reproducible.
+  vector<double> again(size);
+  philox2();
+  philox2.fill_uniform(again.data(), size, 1.0, 10.0);
+  EXPECT_TRUE(values == again) << "Batches should be reproducible.";
+}
+
+TEST(philox_test_suite, test_random_distributions) {
+  Philox philox = Philox(1);
+  uniform_int_distribution<int> distribution(0, 9);
+  vector<int> counts(10, 0);
+  for(int i = 0; i < 10000; i++)
+    counts[distribution(philox)]++;
+  for(int count: counts)
+    EXPECT_NEAR(1000, count, 150) << "Digits should be uniform.";
+  vector<int> keys = { 0, 1, 2, 3, 4, 5 };
+  shuffle(keys.begin(), keys.end(), philox);
+  sort(keys.begin(), keys.end());
+  EXPECT_EQ(5, keys.back()) << "Shuffle should keep all keys.";
+}
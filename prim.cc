@@ -11,6 +11,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_set>
+#include <utility>
 
 using namespace std;
 
@@ -27,10 +28,9 @@ void PriorityQueue::change_priority(int vertex,
   QueueElement& this_element = priority_queue_[position];
 
   assert(this_element.get_priority() > priority);
-  if(parent)
-    this_element.set_parent(parent);
-  
-  // Change priority and percolate upward.
+
+  // Change parent and priority, and percolate upward.
+  this_element.set_parent(parent);
   this_element.set_priority(priority);
   percolate_up(position);
 }
@@ -185,6 +185,31 @@ void Graph::add_edge(int vertex1, int vertex2, double cost) {
   vertices_.emplace(vertex2);
 }
 
+// Add all given edges to the graph.
+void Graph::add_edges(const vector<Edge>& edges) {
+  for(auto& edge: edges)
+    add_edge(edge.vertex1, edge.vertex2, edge.cost);
+}
+
+// Return all edges.
+vector<Edge> Graph::get_edges() {
+  vector<Edge> edges;
+  vector<Edge> neighbor_edges;
+
+  for(int vertex: vertices_) {
+    neighbor_edges.clear();
+    for(auto& info: vertex_edge_map_[vertex])
+      if(vertex < info.first)
+	neighbor_edges.push_back({ vertex, info.first, info.second });
+    sort(neighbor_edges.begin(), neighbor_edges.end(),
+	 [](const Edge& edge1, const Edge& edge2) {
+	   return edge1.vertex2 < edge2.vertex2;
+	 });
+    edges.insert(edges.end(), neighbor_edges.begin(), neighbor_edges.end());
+  }
+  return edges;
+}
+
 // Parse edge line and get vertices and cost.
 void Graph::parse_edge_line(string& line, int& vertex1,
 			    int& vertex2, double& cost) {
@@ -196,14 +221,14 @@ void Graph::parse_edge_line(string& line, int& vertex1,
 }
 
 // Print all edges.
-void Graph::print_edges() {
-  cout << "Edges: " << endl;
+void Graph::print_edges(ostream& out) {
+  out << "Edges: " << endl;
   for(int vertex: vertices_)
-    print_neighbors(vertex);
+    print_neighbors(vertex, out);
 }
 
 // Print neighbors for the given vertex.
-void Graph::print_neighbors(int vertex) {
+void Graph::print_neighbors(int vertex, ostream& out) {
   unordered_map<int, double> neighbor_info = vertex_edge_map_[vertex];
   vector<int> neighbors;
   const char separator = ' ';
@@ -215,15 +240,15 @@ void Graph::print_neighbors(int vertex) {
     neighbors.push_back(kv.first);
   sort(neighbors.begin(), neighbors.end());
   for(int neighbor: neighbors)
-    cout << right << setw(num_width) << setfill(separator) << vertex
-	 << right << setw(num_width) << setfill(separator) << neighbor << endl;
+    out << right << setw(num_width) << setfill(separator) << vertex
+	<< right << setw(num_width) << setfill(separator) << neighbor << endl;
 }
 
-// Read graph from file.
-void Graph::read_file(string& filename) {
-  string line, token;
-  int vertex1, vertex2;
-  double cost;
+// Read edges from graph file.
+vector<Edge> Graph::read_edges(string& filename) {
+  string line;
+  Edge edge;
+  vector<Edge> edges;
   ifstream my_file(filename);
   assert(my_file.is_open());
   
@@ -232,9 +257,15 @@ void Graph::read_file(string& filename) {
 
   // Iterate and read each edge.
   while(getline(my_file, line)) {
-    parse_edge_line(line, vertex1, vertex2, cost);
-    add_edge(vertex1, vertex2, cost);
+    parse_edge_line(line, edge.vertex1, edge.vertex2, edge.cost);
+    edges.push_back(edge);
   }
+  return edges;
+}
+
+// Read graph from file.
+void Graph::read_file(string& filename) {
+  add_edges(read_edges(filename));
 }
 
 // ======
@@ -290,3 +321,56 @@ Graph Prim::mst() {
   }
   return prim_mst;
 }
+
+// =========
+//  Kruskal
+// =========
+
+// Return the endpoints of the given edges as dense indices, numbered in
+// order of first appearance, and store the number of them in count.
+static vector<pair<Vertex, Vertex> > dense_endpoints(
+	const vector<Edge>& edges, Vertex& count) {
+  vector<pair<Vertex, Vertex> > endpoints(edges.size());
+  unordered_map<int, Vertex> indices;
+
+  for(int i = 0; i < int(edges.size()); i++) {
+    Vertex index1 = indices.emplace(edges[i].vertex1,
+				    indices.size()).first->second;
+    Vertex index2 = indices.emplace(edges[i].vertex2,
+				    indices.size()).first->second;
+    endpoints[i] = make_pair(index1, index2);
+  }
+  count = indices.size();
+  return endpoints;
+}
+
+// Compute and return MST.  Vertex ids of a file may be sparse or large,
+// so the union-find runs on their dense indices, of fixed universe.
+Graph Kruskal::mst() {
+  Graph kruskal_mst = Graph();
+  vector<int> order(edges_.size());
+  pair<Vertex, Vertex> pairs[KRUSKAL_BATCH];
+  bool linked[KRUSKAL_BATCH];
+  Vertex vertices;
+  vector<pair<Vertex, Vertex> > endpoints = dense_endpoints(edges_,
+							     vertices);
+  UnionFind uf = UnionFind(vertices);
+
+  for(int i = 0; i < int(order.size()); i++)
+    order[i] = i;
+  stable_sort(order.begin(), order.end(), [&](int i, int j) {
+      return edges_[i].cost < edges_[j].cost;
+    });
+  for(int first = 0; first < int(order.size()); first += KRUSKAL_BATCH) {
+    int size = min<int>(KRUSKAL_BATCH, order.size() - first);
+    for(int i = 0; i < size; i++)
+      pairs[i] = endpoints[order[first + i]];
+    uf.join_many(pairs, size, linked);
+    for(int i = 0; i < size; i++)
+      if(linked[i]) {
+	const Edge& edge = edges_[order[first + i]];
+	kruskal_mst.add_edge(edge.vertex1, edge.vertex2, edge.cost);
+      }
+  }
+  return kruskal_mst;
+}
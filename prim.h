@@ -3,16 +3,27 @@
 #ifndef PRIM_H_
 #define PRIM_H_
 
+#include "union_find.h"
+
 #include <cstdlib>
+#include <iostream>
 #include <set>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 using namespace std;
 const int INIT_CAPACITY = 50;     // Initial priority queue capacity.
+const int KRUSKAL_BATCH = 256;    // Edges joined per batch by Kruskal.
+
+// Edge encapsulates the vertices and cost of an undirected edge.
+struct Edge {
+  int vertex1, vertex2;
+  double cost;
+};
 
 // Queue element encapsulates the priority and vertex ID of element
 // that will be inserted into the priority queue. 
@@ -71,10 +82,10 @@ class PriorityQueue {
   QueueElement top();
 
  private:
-  // Change priority of the given vertex within the priority queue.
-  // Optionally, change parent vertex if provided.  For the purpose of
-  // Prim algorithm, only the reduction of priority is supported.
-  void change_priority(int vertex, double priority, int parent=0);
+  // Change priority and parent vertex of the given vertex within the
+  // priority queue.  For the purpose of Prim algorithm, only the
+  // reduction of priority is supported.
+  void change_priority(int vertex, double priority, int parent);
   // Check if the priority queue contains the given vertex.
   bool contains(int vertex) { return vertex_map_.count(vertex) != 0; }
   // Return the position of left child for a queue element at the
@@ -122,6 +133,8 @@ class Graph {
       vertices_({}) { read_file(filename); }
   // Add edge to the graph.
   void add_edge(int vertex1, int vertex2, double cost=0);
+  // Add all given edges to the graph.
+  void add_edges(const vector<Edge>& edges);
   // Get all neighbor info from the given vertex.  The neighbor info is
   // represented as map with the following format:
   // {{neighbor 1, cost 1}, ..., {neighbor i, cost i}}
@@ -131,8 +144,13 @@ class Graph {
   unordered_map<int, double> get_neighbor_info(int vertex) {
     return vertex_edge_map_[vertex];
   }
+  // Return all edges.  Each undirected edge is returned once with
+  // vertex1 < vertex2, ordered by vertex1 and then by vertex2.
+  vector<Edge> get_edges();
   // Return a vertex from the graph.
   int get_vertex() { return vertex_edge_map_.begin()->first; }
+  // Return the ordered vertex set.
+  const set<int>& get_vertices() { return vertices_; }
   // Check if the graph contains the given vertex.
   bool has_vertex(int vertex) {
     return vertex_edge_map_.count(vertex) != 0; }
@@ -142,7 +160,9 @@ class Graph {
   // - vertex1 vertex3
   // - vertex2 vertex1
   // - vertex3 vertex1
-  void print_edges();
+  void print_edges(ostream& out=cout);
+  // Read edges from graph file without building the graph.
+  static vector<Edge> read_edges(string& filename);
   // Return the (vertex) size of the graph.
   int size() { return vertex_edge_map_.size(); }
   // Return total edge costs.
@@ -150,22 +170,22 @@ class Graph {
 
  private:
   // Get next token from string line.
-  string get_token(istringstream& ss) {
+  static string get_token(istringstream& ss) {
     string token;
     getline(ss, token, ' ');
     return token;
   }
   // Parse edge line and get vertices and cost.
-  void parse_edge_line(string& line, int& vertex1,
-		       int& vertex2, double& cost);
+  static void parse_edge_line(string& line, int& vertex1,
+			      int& vertex2, double& cost);
   // Print neighbors for the given vertex.
-  void print_neighbors(int vertex);
+  void print_neighbors(int vertex, ostream& out);
   // Read graph from file.
   void read_file(string& filename);
   // Convert string to double.
-  double string_to_double(string str) { return atof(str.c_str()); }
+  static double string_to_double(string str) { return atof(str.c_str()); }
   // Convert string to integer.
-  int string_to_int(string str) { return atoi(str.c_str()); }
+  static int string_to_int(string str) { return atoi(str.c_str()); }
   // Total edge costs.
   double edge_costs_;
   // Edge mapping of vertex to its neighbors.  The edges are represented
@@ -219,4 +239,24 @@ class Prim {
   PriorityQueue priority_queue_;
 };
 
+// A class to compute MST using Kruskal algorithm.  Edges are sorted by
+// cost, with ties in input order, and joined in batches of KRUSKAL_BATCH
+// with UnionFind::join_many(), which overlaps the cache misses of the
+// finds of a batch.  Vertex ids are mapped to dense indices first, so
+// sparse or large ids cost no more memory than the edges.  For a
+// disjoint graph the result is a minimum spanning forest.
+class Kruskal {
+ public:
+  // Construct the Kruskal algorithm instance for the given edges, which
+  // it owns, so that a temporary edge list may be passed.  Move a list
+  // in to avoid the copy.
+  Kruskal(vector<Edge> edges) : edges_(move(edges)) {}
+  // Compute and return MST as a graph.
+  Graph mst();
+
+ private:
+  // Undirected edges.
+  vector<Edge> edges_;
+};
+
 #endif // PRIM_H_
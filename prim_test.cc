@@ -93,3 +93,57 @@ TEST(prim_test_suite, test_sample5) {
   EXPECT_EQ(prim.mst().edge_costs(), -3612829)
     << "Min. cost should be -3612829.";
 }
+
+TEST(kruskal_test_suite, test_matches_prim) {
+  // Random connected graphs: a path plus random edges.
+  unsigned state = 3;
+  for(int round = 0; round < 5; round++) {
+    Graph graph = Graph();
+    const int vertices = 300;
+    for(int v = 1; v < vertices; v++) {
+      state = state * 1103515245 + 12345;
+      graph.add_edge(v - 1, v, (state >> 8) % 1000);
+    }
+    for(int i = 0; i < 2000; i++) {
+      state = state * 1103515245 + 12345;
+      int vertex1 = (state >> 8) % vertices;
+      state = state * 1103515245 + 12345;
+      int vertex2 = (state >> 8) % vertices;
+      state = state * 1103515245 + 12345;
+      graph.add_edge(vertex1, vertex2, (state >> 8) % 1000);
+    }
+    vector<Edge> edges = graph.get_edges();
+    Kruskal kruskal = Kruskal(edges);
+    Graph mst = kruskal.mst();
+    Prim prim = Prim(graph);
+    EXPECT_EQ(prim.mst().edge_costs(), mst.edge_costs())
+      << "Kruskal cost should match Prim in round: " << round;
+    EXPECT_EQ(vertices - 1, mst.get_edges().size())
+      << "Spanning tree should have n - 1 edges in round: " << round;
+  }
+}
+
+TEST(kruskal_test_suite, test_sample1_and_forest) {
+  vector<Edge> edges = { { 1, 2, 1 }, { 1, 4, 3 }, { 1, 3, 4 },
+			 { 2, 4, 2 }, { 3, 4, 5 }, { 7, 8, 6 },
+			 { 8, 8, 0 } };
+  Kruskal kruskal = Kruskal(edges);
+  Graph mst = kruskal.mst();
+  EXPECT_EQ(13, mst.edge_costs())
+    << "Min. cost should be 7 for the sample plus 6 for the other tree.";
+  EXPECT_EQ(4, mst.get_edges().size()) << "Forest should have 4 edges.";
+
+  // The instance owns its edges, so a temporary list may be passed.
+  Kruskal owner = Kruskal(vector<Edge>(edges));
+  edges.clear();
+  EXPECT_EQ(13, owner.mst().edge_costs()) << "Owned edges should be kept.";
+}
+
+TEST(kruskal_test_suite, test_sparse_large_ids) {
+  vector<Edge> edges = { { 0, 5, 2 }, { 5, 200000000, 1 },
+			 { 0, 200000000, 3 }, { 1000000, 5, 4 } };
+  Kruskal kruskal = Kruskal(edges);
+  Graph mst = kruskal.mst();
+  EXPECT_EQ(7, mst.edge_costs()) << "Min. cost should be 2 + 1 + 4.";
+  EXPECT_EQ(3, mst.get_edges().size()) << "Tree should have 3 edges.";
+}
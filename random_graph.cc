@@ -4,59 +4,336 @@
 #include "dijkstra.h"
 #include "random_graph.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <stdint.h>
 #include <stdio.h>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
-// Maximum vertex identifier.
-const int MAX_VERTEX_ID = INIT_VERTEX + MAX_VERTICES - 1; 
 // Show individual average path distances.  For debugging only.
 const bool SHOW_AVERAGE_DISTANCES = false;
+// Minimum trials before stopping at a target width, so that the normal
+// approximation of the confidence interval holds.
+const int MIN_ADAPTIVE_TRIALS = 4 * TRIAL_CHUNK;
+// Chunks per worker thread between stopping checks.
+const int CHUNKS_PER_WAVE = 2;
+// Chunks per worker thread per wave of a run without stopping checks.
+const int CHUNKS_PER_FULL_WAVE = 8;
+// Significant digits of reported values.
+const int REPORT_PRECISION = 9;
+// Magic number at the start of checkpoint files ("SIMC").
+const uint32_t CHECKPOINT_MAGIC = 0x434d4953;
+const uint32_t CHECKPOINT_VERSION = 2;  // Checkpoint format version.
+
+// Write value in binary, in the byte order of the host.
+template <typename T>
+static void write_value(ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Read value in binary, in the byte order of the host.  A short read
+// returns 0 and leaves the stream failed, which callers check once after
+// reading.
+template <typename T>
+static T read_value(istream& in) {
+  T value = T();
+  in.read(reinterpret_cast<char*>(&value), sizeof(value));
+  return value;
+}
+
+// Write string in binary: its uint32 length, then its characters.
+static void write_string(ostream& out, const string& value) {
+  write_value<uint32_t>(out, value.size());
+  out.write(value.data(), value.size());
+}
+
+// Read string in binary.  A short read returns a partial string and
+// leaves the stream failed, as read_value() does.
+static string read_string(istream& in) {
+  uint32_t size = read_value<uint32_t>(in);
+  string value;
+
+  // Read in pieces, so that a corrupt length cannot allocate much.
+  while(in && value.size() < size) {
+    char buffer[256];
+    in.read(buffer, min<uint32_t>(sizeof(buffer), size - value.size()));
+    value.append(buffer, in.gcount());
+  }
+  return value;
+}
 using namespace std;
 
+// ==============
+//  TrialContext
+// ==============
+
+// Compute shortest-path distances from the given source.  An isolated
+// source reaches no other vertex.
+const vector<double>& TrialContext::shortest_path_distances(int source) {
+  if(graph_.neighbors(source).empty()) {
+    distances_.assign(distances_.size(), NO_PATH);
+    distances_[source] = 0.0;
+  } else {
+    dijkstra_.shortest_paths(graph_, source, distances_);
+  }
+  return distances_;
+}
+
 // =============
 //  RandomGraph
 // =============
 
-// Generate a random graph.
+// Generate a random graph.  Vertex pairs (vertex1, vertex2) with
+// vertex1 < vertex2 are visited in row order, skipping the pairs
+// without edges.
 void RandomGraph::get_random_graph() {
-  for(int vertex1 = INIT_VERTEX; vertex1 < MAX_VERTEX_ID; vertex1++)
-    for(int vertex2 = vertex1 + 1; vertex2 <= MAX_VERTEX_ID; vertex2++)
-      if(random_edge()) {
-	graph_.add_edge(vertex1, vertex2, random_distance());
+  const double max_skip = MAX_VERTICES * MAX_VERTICES;
+  int vertex1 = INIT_VERTEX, vertex2 = INIT_VERTEX;
+
+  context_->destinations()[INIT_VERTEX] = true;
+  if(edge_density_ <= 0.0)
+    return;
+  while(vertex1 < MAX_VERTEX_ID) {
+
+    // Advance past the skipped pairs, wrapping to the following rows.
+    vertex2 += 1 + min(random_skip(), max_skip);
+    while(vertex2 > MAX_VERTEX_ID && vertex1 < MAX_VERTEX_ID) {
+      vertex2 = vertex2 - MAX_VERTEX_ID + vertex1 + 1;
+      vertex1++;
+    }
+    if(vertex1 >= MAX_VERTEX_ID)
+      break;
+    context_->graph().add_edge(vertex1, vertex2, random_distance());
+    context_->components().join(vertex1, vertex2);
 
-	// For statistics.
-	destinations_.emplace(vertex1);
-	destinations_.emplace(vertex2);
-	edges_++;
-      }
+    // For statistics.
+    context_->destinations()[vertex1] = true;
+    context_->destinations()[vertex2] = true;
+    edges_++;
+  }
+}
+
+// Return random number of vertex pairs to skip before the next edge.
+double RandomGraph::random_skip() {
+  if(edge_density_ >= 1.0)
+    return 0.0;
+  return floor(log(1.0 - random_uniform()) /
+	       log(1.0 - edge_density_));
+}
+
+// Return the number of destinations.
+int RandomGraph::destinations() const {
+  vector<bool>& destinations = context_->destinations();
+  return count(destinations.begin(), destinations.end(), true);
 }
 
 // Compute shortest-path distances from INIT_VERTEX.
 unordered_map<int, double> RandomGraph::shortest_paths() {
-  Dijkstra dsa = Dijkstra(graph_);
-  unordered_map<int, double> results = dsa.shortest_paths(INIT_VERTEX);
+  const vector<double>& distances = shortest_path_distances();
+  unordered_map<int, double> results;
+
+  for(int vertex = INIT_VERTEX; vertex <= MAX_VERTEX_ID; vertex++)
+    if(distances[vertex] != NO_PATH)
+      results.emplace(vertex, distances[vertex]);
   return results;
 }
 
+
+// Return the number of worker threads to use for the given setting.
+static int worker_threads(int threads) {
+  if(threads <= 0)
+    return max(1u, thread::hardware_concurrency());
+  return threads;
+}
+
+// ================
+//  QuantileSketch
+// ================
+
+// Add value data point.
+void QuantileSketch::add(double value) {
+  int index;
+
+  assert(value >= 0.0);
+  total_++;
+  if(value == 0.0) {
+    zeros_++;
+    return;
+  }
+  index = bucket(value);
+  grow(index);
+  counts_[index - offset_]++;
+}
+
+// Remove all data points and keep the buckets.
+void QuantileSketch::clear() {
+  fill(counts_.begin(), counts_.end(), 0);
+  total_ = zeros_ = 0;
+}
+
+// Make bucket of the given index available.
+void QuantileSketch::grow(int index) {
+  if(counts_.empty()) {
+    counts_.push_back(0);
+    offset_ = index;
+  } else if(index < offset_) {
+    counts_.insert(counts_.begin(), offset_ - index, 0);
+    offset_ = index;
+  } else if(index >= offset_ + static_cast<int>(counts_.size())) {
+    counts_.resize(index - offset_ + 1, 0);
+  }
+}
+
+// Merge data points of another sketch.
+void QuantileSketch::merge(const QuantileSketch& other) {
+  assert(gamma_ == other.gamma_);
+  if(!other.counts_.empty()) {
+    grow(other.offset_);
+    grow(other.offset_ + static_cast<int>(other.counts_.size()) - 1);
+    for(int i = 0; i < static_cast<int>(other.counts_.size()); i++)
+      counts_[other.offset_ - offset_ + i] += other.counts_[i];
+  }
+  total_ += other.total_;
+  zeros_ += other.zeros_;
+}
+
+// Read sketch in binary from the stream.
+void QuantileSketch::read(istream& in) {
+  gamma_ = read_value<double>(in);
+  inverse_log_gamma_ = 1.0 / log(gamma_);
+  offset_ = read_value<int32_t>(in);
+  total_ = read_value<int64_t>(in);
+  zeros_ = read_value<int64_t>(in);
+
+  // Read counts one by one, so that a corrupt size stops at the end of
+  // the stream instead of allocating it.
+  uint64_t size = read_value<uint64_t>(in);
+  counts_.clear();
+  for(uint64_t i = 0; i < size && in; i++)
+    counts_.push_back(read_value<int64_t>(in));
+}
+
+// Make buckets of the given range available.  Zeros are counted apart,
+// so a range that is not positive needs none.
+void QuantileSketch::reserve(double min_value, double max_value) {
+  if(min_value <= 0.0 || max_value < min_value)
+    return;
+  grow(bucket(min_value));
+  grow(bucket(max_value));
+}
+
+// Write sketch in binary to the stream.
+void QuantileSketch::write(ostream& out) const {
+  write_value<double>(out, gamma_);
+  write_value<int32_t>(out, offset_);
+  write_value<int64_t>(out, total_);
+  write_value<int64_t>(out, zeros_);
+  write_value<uint64_t>(out, counts_.size());
+  for(long count: counts_)
+    write_value<int64_t>(out, count);
+}
+
+// Return estimate of the given quantile.
+double QuantileSketch::quantile(double q) const {
+  long rank, seen = zeros_;
+
+  if(!total_)
+    return 0.0;
+
+  // Rank of the quantile among the data points, counting from 0.
+  rank = static_cast<long>(q * (total_ - 1));
+  if(rank < seen)
+    return 0.0;
+  for(int i = 0; i < static_cast<int>(counts_.size()); i++) {
+    seen += counts_[i];
+    if(rank < seen)
+      return 2.0 * pow(gamma_, offset_ + i) / (gamma_ + 1.0);
+  }
+  return 2.0 * pow(gamma_, offset_ + static_cast<int>(counts_.size()) - 1) /
+    (gamma_ + 1.0);
+}
+
+// =================
+//  SPDistanceStats
+// =================
+
+// Merge data points of another statistics instance.
+void SPDistanceStats::merge(const SPDistanceStats& other) {
+  long total = total_ + other.total_;
+  double delta = other.mean_ - mean_;
+
+  sketch_.merge(other.sketch_);
+  if(!total)
+    return;
+  m2_ += other.m2_ + delta * delta * total_ * other.total_ / total;
+  mean_ += delta * other.total_ / total;
+  total_ = total;
+}
+
+// Read statistics in binary from the stream.
+void SPDistanceStats::read(istream& in) {
+  m2_ = read_value<double>(in);
+  mean_ = read_value<double>(in);
+  total_ = read_value<int64_t>(in);
+  sketch_.read(in);
+}
+
+// Write statistics in binary to the stream.
+void SPDistanceStats::write(ostream& out) const {
+  write_value<double>(out, m2_);
+  write_value<double>(out, mean_);
+  write_value<int64_t>(out, total_);
+  sketch_.write(out);
+}
+
+// Run chunk function for all chunks on worker threads.
+void run_chunks(int chunks, int threads,
+		const function<void(int, TrialContext&)>& chunk_function) {
+  vector<thread> workers;
+  atomic<int> next_chunk(0);
+
+  threads = min(worker_threads(threads), chunks);
+  for(int i = 0; i < threads; i++)
+    workers.push_back(thread([&]() {
+	  TrialContext context = TrialContext();
+	  for(int chunk = next_chunk++; chunk < chunks; chunk = next_chunk++)
+	    chunk_function(chunk, context);
+	}));
+  for(auto& w: workers)
+    w.join();
+}
+
 // ============
 //  Simulation
 // ============
 
+// Add shortest-path distances to the statistics of each destination.
+void add_path_distances(const vector<double>& distances,
+			vector<SPDistanceStats>& stats) {
+  for(int vertex = INIT_VERTEX; vertex <= MAX_VERTEX_ID; vertex++)
+    if(distances[vertex] != NO_PATH)
+      stats[vertex - INIT_VERTEX].add(distances[vertex]);
+}
+
 // Return average path distances over all shortest paths.
-double Simulation::average() {
-  double avg_distance, total = 0.0;
+double average_path_distance(const vector<SPDistanceStats>& stats) {
+  double total = 0.0;
   int number = 0;
 
   for(int i = 1; i < MAX_VERTICES; i++) {
-    avg_distance = stats_[i].average();
 
-    // Skip vertex without average distance.  This should be unlikely.
-    if(avg_distance == 0.0)
+    // Skip vertex that was never reached.  This should be unlikely.
+    if(!stats[i].size())
       continue;
-    total += avg_distance;
+    total += stats[i].average();
     number++;
   }
   if(!number)
@@ -64,48 +341,489 @@ double Simulation::average() {
   return total / number;
 }
 
-// Process results of shortest-path computation in random graph.
-void Simulation::process_results(unordered_map<int, double>& results) {
-  for(auto& result: results)
-    stats_[index(result.first)].add(result.second);
+// Remove all statistics, keeping the storage for reuse.
+void SimulationStats::clear() {
+  aggregate_seconds = generate_seconds = sssp_seconds = 0.0;
+  for(auto& stats: destinations)
+    stats.clear();
+  resamples = 0;
+  source_components.clear();
+  trials.clear();
+}
+
+// Merge statistics of other trials.
+void SimulationStats::merge(const SimulationStats& other) {
+  for(int i = 0; i < MAX_VERTICES; i++)
+    destinations[i].merge(other.destinations[i]);
+  aggregate_seconds += other.aggregate_seconds;
+  generate_seconds += other.generate_seconds;
+  resamples += other.resamples;
+  source_components.merge(other.source_components);
+  sssp_seconds += other.sssp_seconds;
+  trials.merge(other.trials);
+}
+
+// Read statistics in binary from the stream.
+void SimulationStats::read(istream& in) {
+  if(read_value<int32_t>(in) != MAX_VERTICES) {
+    in.setstate(ios::failbit);
+    return;
+  }
+  destinations.assign(MAX_VERTICES, SPDistanceStats());
+  for(auto& stats: destinations)
+    stats.read(in);
+  resamples = read_value<int64_t>(in);
+  source_components.read(in);
+  trials.read(in);
+}
+
+// Make the statistics ready for the given range of edge distances.  A
+// shortest path has from 1 to MAX_VERTICES - 1 edges, and so does the
+// average of a trial.
+void SimulationStats::reserve(double min_distance, double max_distance) {
+  for(auto& stats: destinations)
+    stats.reserve(min_distance, (MAX_VERTICES - 1) * max_distance);
+  source_components.reserve(1, MAX_VERTICES);
+  trials.reserve(min_distance, (MAX_VERTICES - 1) * max_distance);
+}
+
+// Write statistics in binary to the stream.
+void SimulationStats::write(ostream& out) const {
+  write_value<int32_t>(out, destinations.size());
+  for(auto& stats: destinations)
+    stats.write(out);
+  write_value<int64_t>(out, resamples);
+  source_components.write(out);
+  trials.write(out);
 }
 
-// Run simulation and collect statistics.
+// Write a checkpoint.  The file holds the settings that determine the
+// results, except for the number of trials, then the number of trials
+// run and the statistics.  The settings include the description of the
+// generator, so a checkpoint of another model or size is not resumed.
+bool Simulation::checkpoint() {
+  string temporary = checkpoint_file_ + ".tmp";
+  ofstream out(temporary, ios::binary);
+
+  if(!out.is_open())
+    return false;
+  write_value<uint32_t>(out, CHECKPOINT_MAGIC);
+  write_value<uint32_t>(out, CHECKPOINT_VERSION);
+  write_value<double>(out, edge_density_);
+  write_value<double>(out, min_distance_);
+  write_value<double>(out, max_distance_);
+  write_value<uint32_t>(out, seed_);
+  write_value<double>(out, target_width_);
+  write_value<uint8_t>(out, resample_);
+  write_string(out, generator_description());
+  write_value<int32_t>(out, trials_run_);
+  stats_.write(out);
+  out.close();
+  if(!out || rename(temporary.c_str(), checkpoint_file_.c_str())) {
+    remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Resume from the given checkpoint file.  The number of trials may grow
+// to extend a run whose trials run end at a chunk boundary, since the
+// trials of each chunk do not depend on the total.
+bool Simulation::resume(const string& filename) {
+  ifstream in(filename, ios::binary);
+  SimulationStats stats;
+
+  if(!in.is_open())
+    return false;
+  if(read_value<uint32_t>(in) != CHECKPOINT_MAGIC ||
+     read_value<uint32_t>(in) != CHECKPOINT_VERSION)
+    return false;
+  if(read_value<double>(in) != edge_density_ ||
+     read_value<double>(in) != min_distance_ ||
+     read_value<double>(in) != max_distance_ ||
+     read_value<uint32_t>(in) != seed_ ||
+     read_value<double>(in) != target_width_ ||
+     read_value<uint8_t>(in) != resample_ ||
+     read_string(in) != generator_description())
+    return false;
+  int trials_run = read_value<int32_t>(in);
+  if(!in || trials_run < 0 || trials_run > trials_ ||
+     (trials_run % TRIAL_CHUNK && trials_run != trials_))
+    return false;
+
+  // Keep the state of the simulation unless the whole file is read.
+  stats.read(in);
+  if(!in)
+    return false;
+  trials_run_ = resumed_trials_ = trials_run;
+  stats_ = stats;
+  return true;
+}
+
+// Return whether the confidence interval is narrow enough to stop.
+bool Simulation::converged() const {
+  double mean = stats_.trials.average();
+
+  if(target_width_ <= 0.0 || trials_run_ < MIN_ADAPTIVE_TRIALS)
+    return false;
+  return 2.0 * stats_.trials.confidence_interval() <= target_width_ * mean;
+}
+
+// Run simulation and collect statistics, starting after the trials
+// already run.  Chunks run in waves of CHUNKS_PER_FULL_WAVE chunks per
+// thread, or of CHUNKS_PER_WAVE with a target width, or fewer between
+// checkpoints, and chunks of the last wave after the stopping chunk are
+// dropped.  The statistics of a wave are reserved for the distance range
+// once, then cleared and reused by the next wave, so that trials add to
+// them without allocation.  The stopping check runs after
+// every chunk merged, in chunk order, so where a run stops depends on
+// neither the wave size nor the checkpoints.  A failed checkpoint is
+// reported once and the run goes on.
 void Simulation::run() {
-  unordered_map<int, double> results;
+  int chunks = (trials_ + TRIAL_CHUNK - 1) / TRIAL_CHUNK;
+  int wave = CHUNKS_PER_FULL_WAVE * worker_threads(threads_);
+  vector<SimulationStats> chunk_stats;
+  Stopwatch stopwatch = Stopwatch();
+  bool checkpoint_failed = false;
+
+  if(target_width_ > 0.0)
+    wave = CHUNKS_PER_WAVE * worker_threads(threads_);
+  if(!checkpoint_file_.empty())
+    wave = min(wave, checkpoint_chunks_);
+  for(int first = (trials_run_ + TRIAL_CHUNK - 1) / TRIAL_CHUNK;
+      first < chunks && !converged(); first += wave) {
+    int size = min(wave, chunks - first);
+    while(static_cast<int>(chunk_stats.size()) < size) {
+      chunk_stats.push_back(SimulationStats());
+      chunk_stats.back().reserve(min_distance_, max_distance_);
+    }
+    for(int i = 0; i < size; i++)
+      chunk_stats[i].clear();
+    run_chunks(size, threads_, [&](int i, TrialContext& context) {
+	run_chunk(first + i, context, chunk_stats[i]);
+      });
 
-  for(int trial = 0; trial < trials_; trial++) {
-    RandomGraph rgraph = RandomGraph(edge_density_, min_distance_, max_distance_);
-    results = rgraph.shortest_paths();
-    process_results(results);
+    // Merge chunk statistics in chunk order.
+    for(int i = 0; i < size && !converged(); i++) {
+      stats_.merge(chunk_stats[i]);
+      trials_run_ = min(trials_, (first + i + 1) * TRIAL_CHUNK);
+    }
+    if(!checkpoint_file_.empty() && !checkpoint() && !checkpoint_failed) {
+      cout << "Unable to write checkpoint: " << checkpoint_file_ << endl;
+      checkpoint_failed = true;
+    }
+  }
+  run_seconds_ = stopwatch.elapsed();
+}
+
+// Add shortest-path distances of a trial to the statistics.
+void Simulation::add_trial(const vector<double>& distances,
+			   int component_size, SimulationStats& stats) {
+  double total = 0.0;
+  int number = 0;
+
+  add_path_distances(distances, stats.destinations);
+  stats.source_components.add(component_size);
+
+  // Average path distance of the trial over reachable destinations.
+  // Skip trial without any, like average_path_distance() does.
+  for(int vertex = INIT_VERTEX + 1; vertex <= MAX_VERTEX_ID; vertex++)
+    if(distances[vertex] != NO_PATH) {
+      total += distances[vertex];
+      number++;
+    }
+  if(number)
+    stats.trials.add(total / number);
+}
+
+// Generate the graph of the given trial in the given context.  Graphs
+// of a generator are joined in the union-find after generation.
+int Simulation::generate_trial(int trial, TrialContext& context,
+			       SimulationStats& stats) {
+  int component_size;
+
+  // The random graph is built in the context.
+  if(!generator_) {
+    RandomGraph rgraph = RandomGraph(edge_density_, min_distance_,
+				     max_distance_, seed_, trial, context);
+    component_size = rgraph.component_size(INIT_VERTEX);
+    for(int i = 0; resample_ && component_size < MAX_VERTICES &&
+	  i < MAX_RESAMPLES; i++) {
+      rgraph.resample();
+      component_size = rgraph.component_size(INIT_VERTEX);
+      stats.resamples++;
+    }
+    return component_size;
+  }
+  Philox generator = Philox(seed_, trial);
+  AdjacencyGraphSink sink = AdjacencyGraphSink(context.graph(), INIT_VERTEX);
+  for(int i = 0; i <= MAX_RESAMPLES; i++) {
+    if(i)
+      stats.resamples++;
+    context.reset();
+    generator_->generate(generator, sink);
+    for(int vertex = INIT_VERTEX; vertex <= MAX_VERTEX_ID; vertex++)
+      for(auto& neighbor: context.graph().neighbors(vertex))
+	context.components().join(vertex, neighbor.vertex);
+    component_size = context.component_size(INIT_VERTEX);
+    if(!resample_ || component_size == MAX_VERTICES)
+      break;
   }
+  return component_size;
 }
 
-// Print simulation results.
+// Run trials of the given chunk in the given context and collect their
+// statistics.  In batched mode, each batch loads the graphs of up to
+// BATCH_LANES trials into the lanes, solves them together and adds the
+// results in trial order.
+void Simulation::run_chunk(int chunk, TrialContext& context,
+			   SimulationStats& stats) {
+  int end = min(trials_, (chunk + 1) * TRIAL_CHUNK);
+  int component_sizes[BATCH_LANES], component_size, lanes;
+  Stopwatch stopwatch = Stopwatch();
+
+  if(!batched_) {
+    for(int trial = chunk * TRIAL_CHUNK; trial < end; trial++) {
+      stopwatch.restart();
+      component_size = generate_trial(trial, context, stats);
+      stats.generate_seconds += stopwatch.lap();
+      const vector<double>& distances =
+	context.shortest_path_distances(INIT_VERTEX);
+      stats.sssp_seconds += stopwatch.lap();
+      add_trial(distances, component_size, stats);
+      stats.aggregate_seconds += stopwatch.elapsed();
+    }
+    return;
+  }
+
+  // Loading the lanes counts as generation, and extracting the distances
+  // of the lanes as aggregation.
+  BatchedDijkstra& batch = context.batched_dijkstra();
+  for(int first = chunk * TRIAL_CHUNK; first < end; first += BATCH_LANES) {
+    lanes = min(BATCH_LANES, end - first);
+    stopwatch.restart();
+    batch.clear();
+    for(int lane = 0; lane < lanes; lane++) {
+      component_sizes[lane] = generate_trial(first + lane, context, stats);
+      batch.load(lane, context.graph());
+    }
+    stats.generate_seconds += stopwatch.lap();
+    batch.shortest_paths(INIT_VERTEX);
+    stats.sssp_seconds += stopwatch.lap();
+    for(int lane = 0; lane < lanes; lane++) {
+      batch.distances(lane, context.distances());
+      add_trial(context.distances(), component_sizes[lane], stats);
+    }
+    stats.aggregate_seconds += stopwatch.elapsed();
+  }
+}
+
+// Print simulation results.  Lines end with '\n' and the stream is
+// flushed once at the end.
 void Simulation::print() {
   const char separator = ' ';
   const int field_width = 10;
   const int num_width = 10;
-  char path[10];
 
-  cout << "Edge density: " << edge_density_ << endl;
+  cout << "Edge density: " << edge_density_ << '\n';
   cout << "  Average path distance: " << fixed << setprecision(2) << average()
-       << endl;
-  if(!SHOW_AVERAGE_DISTANCES)
+       << '\n';
+  cout << "  Average source component size: "
+       << stats_.source_components.average() << '\n';
+  if(resample_)
+    cout << "  Resampled graphs: " << stats_.resamples << '\n';
+  if(target_width_ > 0.0)
+    cout << "  Trials: " << trials_run() << ", 95% confidence interval: +/- "
+	 << stats_.trials.confidence_interval() << '\n';
+  if(!SHOW_AVERAGE_DISTANCES) {
+    cout.flush();
     return;
+  }
 
   // For debugging only.
-  cout << endl;
+  cout << '\n';
   cout << left << setw(field_width)<< setfill(separator) << "";
-  cout << right << setw(field_width) << setfill(separator) << "Average" << endl;
+  cout << right << setw(field_width) << setfill(separator) << "Average" << '\n';
   cout << left << setw(field_width) << setfill(separator) << "Paths";
-  cout << right << setw(field_width) << setfill(separator) << "Distances" << endl;
-  cout << "======================" << endl;
+  cout << right << setw(field_width) << setfill(separator) << "Distances" << '\n';
+  cout << "======================" << '\n';
   for(int i = 1, destination = INIT_VERTEX+1; i < MAX_VERTICES; i++, destination++) {
-    sprintf(path, "%d to %d", INIT_VERTEX, destination);
+    string path = to_string(INIT_VERTEX) + " to " + to_string(destination);
     cout << left << setw(field_width) << setfill(separator) << path;
     cout << right << setw(num_width) << setfill(separator)
-	 << fixed << setprecision(2) << stats_[i].average() << endl;
+	 << fixed << setprecision(2) << stats_.destinations[i].average()
+	 << '\n';
   }
   cout << endl;
 }
+
+// Write the CSV header line of write_report().
+void Simulation::write_csv_header(ostream& out) {
+  out << "edge_density,seed,trials,trials_run,batched,resample,"
+      << "average_path_distance,confidence_interval,source_component_size,"
+      << "resamples,run_seconds,generate_seconds,sssp_seconds,"
+      << "aggregate_seconds,trials_per_second,destination,samples,mean,"
+      << "variance,destination_confidence_interval,p50,p99\n";
+}
+
+// Write simulation results in the given format.  Destinations are the
+// vertices other than INIT_VERTEX.
+void Simulation::write_report(ostream& out, ReportFormat format) const {
+  ios::fmtflags flags = out.flags();
+  streamsize precision = out.precision();
+  double mean = average_path_distance(stats_.destinations);
+
+  out.unsetf(ios::floatfield);
+  out << setprecision(REPORT_PRECISION);
+  if(format == ReportFormat::CSV) {
+    for(int i = 1; i < MAX_VERTICES; i++) {
+      const SPDistanceStats& stats = stats_.destinations[i];
+      out << edge_density_ << ',' << seed_ << ',' << trials_ << ','
+	  << trials_run_ << ',' << batched_ << ',' << resample_ << ','
+	  << mean << ',' << stats_.trials.confidence_interval() << ','
+	  << stats_.source_components.average() << ',' << stats_.resamples
+	  << ',' << run_seconds_ << ',' << stats_.generate_seconds << ','
+	  << stats_.sssp_seconds << ',' << stats_.aggregate_seconds << ','
+	  << trials_per_second() << ',' << INIT_VERTEX + i << ','
+	  << stats.size() << ',' << stats.average() << ','
+	  << stats.variance() << ',' << stats.confidence_interval() << ','
+	  << stats.quantile(0.5) << ',' << stats.quantile(0.99) << '\n';
+    }
+  } else {
+    out << "{\"edge_density\": " << edge_density_
+	<< ", \"seed\": " << seed_
+	<< ", \"trials\": " << trials_
+	<< ", \"trials_run\": " << trials_run_
+	<< ", \"batched\": " << (batched_ ? "true" : "false")
+	<< ", \"resample\": " << (resample_ ? "true" : "false")
+	<< ", \"average_path_distance\": " << mean
+	<< ", \"confidence_interval\": "
+	<< stats_.trials.confidence_interval()
+	<< ", \"source_component_size\": "
+	<< stats_.source_components.average()
+	<< ", \"resamples\": " << stats_.resamples
+	<< ", \"timing\": {\"run_seconds\": " << run_seconds_
+	<< ", \"generate_seconds\": " << stats_.generate_seconds
+	<< ", \"sssp_seconds\": " << stats_.sssp_seconds
+	<< ", \"aggregate_seconds\": " << stats_.aggregate_seconds
+	<< ", \"trials_per_second\": " << trials_per_second() << '}'
+	<< ", \"destinations\": [";
+    for(int i = 1; i < MAX_VERTICES; i++) {
+      const SPDistanceStats& stats = stats_.destinations[i];
+      if(i > 1)
+	out << ", ";
+      out << "{\"destination\": " << INIT_VERTEX + i
+	  << ", \"samples\": " << stats.size()
+	  << ", \"mean\": " << stats.average()
+	  << ", \"variance\": " << stats.variance()
+	  << ", \"confidence_interval\": " << stats.confidence_interval()
+	  << ", \"p50\": " << stats.quantile(0.5)
+	  << ", \"p99\": " << stats.quantile(0.99) << '}';
+    }
+    out << "]}\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+// ==============
+//  DensitySweep
+// ==============
+
+// Construct a density sweep.
+DensitySweep::DensitySweep(const vector<double>& edge_densities,
+			   double min_distance, double max_distance,
+			   int trials, unsigned seed, int threads)
+  : edge_densities_(edge_densities),
+    max_distance_(max_distance),
+    min_distance_(min_distance),
+    seed_(seed),
+    threads_(threads),
+    trials_(trials) {
+  assert(!edge_densities_.empty());
+  sort(edge_densities_.begin(), edge_densities_.end());
+  stats_.assign(edge_densities_.size(),
+		vector<SPDistanceStats>(MAX_VERTICES));
+}
+
+// Print sweep results.
+void DensitySweep::print() {
+  for(int i = 0; i < static_cast<int>(edge_densities_.size()); i++) {
+    cout << "Edge density: " << edge_densities_[i] << endl;
+    cout << "  Average path distance: " << fixed << setprecision(2)
+	 << average(i) << endl;
+  }
+}
+
+// Run sweep and collect statistics.
+void DensitySweep::run() {
+  int chunks = (trials_ + TRIAL_CHUNK - 1) / TRIAL_CHUNK;
+  vector<vector<vector<SPDistanceStats> > > chunk_stats(chunks);
+
+  run_chunks(chunks, threads_, [&](int chunk, TrialContext& context) {
+      run_chunk(chunk, context, chunk_stats[chunk]);
+    });
+
+  // Merge chunk statistics in chunk order.
+  for(auto& stats: chunk_stats)
+    for(size_t i = 0; i < edge_densities_.size(); i++)
+      for(int j = 0; j < MAX_VERTICES; j++)
+	stats_[i][j].merge(stats[i][j]);
+}
+
+// Run trials of the given chunk in the given context and collect their
+// statistics for each density.
+void DensitySweep::run_chunk(int chunk, TrialContext& context,
+			     vector<vector<SPDistanceStats> >& stats) {
+  int end = min(trials_, (chunk + 1) * TRIAL_CHUNK);
+  vector<SweepEdge> edges;
+
+  stats.assign(edge_densities_.size(),
+	       vector<SPDistanceStats>(MAX_VERTICES));
+  edges.reserve(MAX_VERTICES * (MAX_VERTICES - 1) / 2);
+  for(int trial = chunk * TRIAL_CHUNK; trial < end; trial++)
+    run_trial(trial, context, edges, stats);
+}
+
+// Run a trial in the given context and collect its statistics for each
+// density.
+void DensitySweep::run_trial(int trial, TrialContext& context,
+			     vector<SweepEdge>& edges,
+			     vector<vector<SPDistanceStats> >& stats) {
+  Philox generator = Philox(seed_, trial);
+  vector<double>& uniforms = context.uniforms();
+  vector<double>& distances = context.distances();
+  double max_density = edge_densities_.back();
+  int next = 0;
+  size_t density_index = 0;
+
+  // Draw a uniform and a distance per vertex pair in row order, keeping
+  // only pairs present at the largest density.
+  context.reset();
+  edges.clear();
+  for(int vertex1 = INIT_VERTEX; vertex1 < MAX_VERTEX_ID; vertex1++)
+    for(int vertex2 = vertex1 + 1; vertex2 <= MAX_VERTEX_ID; vertex2++) {
+      if(next == 0)
+	generator.fill_uniform(uniforms.data(), UNIFORM_BATCH);
+      SweepEdge edge = { uniforms[next], vertex1, vertex2,
+			 min_distance_ + (max_distance_ - min_distance_) *
+			 uniforms[next + 1] };
+      next = (next + 2) % UNIFORM_BATCH;
+      if(edge.uniform < max_density)
+	edges.push_back(edge);
+    }
+  sort(edges.begin(), edges.end());
+
+  // Add edges in order of their uniforms and record distances as each
+  // density is passed.
+  distances.assign(distances.size(), NO_PATH);
+  distances[INIT_VERTEX] = 0.0;
+  for(auto& edge: edges) {
+    while(edge.uniform >= edge_densities_[density_index])
+      add_path_distances(distances, stats[density_index++]);
+    context.dijkstra().insert_edge(context.graph(), edge.vertex1,
+				   edge.vertex2, edge.distance, distances);
+  }
+  while(density_index < edge_densities_.size())
+    add_path_distances(distances, stats[density_index++]);
+}
@@ -3,124 +3,623 @@
 #ifndef RANDOM_GRAPH_H_
 #define RANDOM_GRAPH_H_
 
+#include "batched_dijkstra.h"
+#include "benchmark.h"
 #include "dijkstra.h"
+#include "graph_generators.h"
+#include "philox.h"
+#include "union_find.h"
 
+#include <assert.h>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 const int INIT_VERTEX = 1;  // Initial vertex.
+// Maximum vertex identifier.
+const int MAX_VERTEX_ID = INIT_VERTEX + MAX_VERTICES - 1;
+const int TRIAL_CHUNK = 16; // Trials per unit of work in simulation.
+const int UNIFORM_BATCH = 256;  // Uniforms generated per batch.
+const int MAX_RESAMPLES = 1000; // Maximum redraws of a disconnected graph.
 using namespace std;
 
+// Return a seed from the system clock.
+inline unsigned clock_seed() {
+  return chrono::system_clock::now().time_since_epoch().count();
+}
+
+// Reusable storage for the trials of one simulation worker.  It owns the
+// graph, the Dijkstra heap, the shortest-path results, the uniform batch
+// and the destination flags of a trial.  reset() clears them for the next
+// trial without freeing memory, so that trials in steady state do not
+// allocate.  The batched Dijkstra instance is created on first use.  The
+// context also tracks the connected components of the graph in a
+// union-find, which the graph builder updates with each edge.
+class TrialContext {
+ public:
+  // Construct a trial context.
+  TrialContext()
+    : components_(UnionFind(MAX_VERTEX_ID + 1)),
+      destinations_(MAX_VERTEX_ID + 1, false),
+      dijkstra_(AdjacencyDijkstra(MAX_VERTEX_ID + 1)),
+      distances_(MAX_VERTEX_ID + 1, NO_PATH),
+      graph_(AdjacencyGraph(MAX_VERTEX_ID + 1)),
+      uniforms_(UNIFORM_BATCH) {}
+  // Return union-find of the connected components of the graph.
+  UnionFind& components() { return components_; }
+  // Return the size of the connected component of the given vertex.
+  int component_size(int vertex) {
+    return components_.component_size(vertex);
+  }
+  // Return batched Dijkstra algorithm instance.
+  BatchedDijkstra& batched_dijkstra() {
+    if(!batched_dijkstra_)
+      batched_dijkstra_.reset(new BatchedDijkstra(MAX_VERTEX_ID + 1));
+    return *batched_dijkstra_;
+  }
+  // Return destination flags indexed by vertex.
+  vector<bool>& destinations() { return destinations_; }
+  // Return Dijkstra algorithm instance.
+  AdjacencyDijkstra& dijkstra() { return dijkstra_; }
+  // Return shortest-path distances indexed by vertex.
+  vector<double>& distances() { return distances_; }
+  // Return graph of the trial.
+  AdjacencyGraph& graph() { return graph_; }
+  // Clear the context for the next trial.
+  void reset() {
+    components_.clear();
+    destinations_.assign(destinations_.size(), false);
+    graph_.reset();
+  }
+  // Compute shortest-path distances from the given source into the
+  // distances of the context and return them.  Dijkstra is skipped if
+  // the source is isolated.
+  const vector<double>& shortest_path_distances(int source);
+  // Return batch of uniforms.
+  vector<double>& uniforms() { return uniforms_; }
+
+ private:
+  // Batched Dijkstra algorithm instance, if used.
+  unique_ptr<BatchedDijkstra> batched_dijkstra_;
+  // Connected components of the graph.
+  UnionFind components_;
+  // Flags of vertices with edges.
+  vector<bool> destinations_;
+  // Dijkstra algorithm instance with its heap.
+  AdjacencyDijkstra dijkstra_;
+  // Shortest-path distances of the trial.
+  vector<double> distances_;
+  // Graph of the trial.
+  AdjacencyGraph graph_;
+  // Batch of uniforms in [0, 1).
+  vector<double> uniforms_;
+};
+
 // A class to generate a random graph and calculate single-source
-// shortest paths in the graph using Dijkstra algorithm.
+// shortest paths in the graph using Dijkstra algorithm.  Random numbers
+// come from the Philox stream addressed by (seed, stream), so a graph
+// can be regenerated from those two numbers alone.  The graph lives in a
+// TrialContext, which is either given by the caller for reuse across
+// trials or owned by the random graph.
 class RandomGraph {
  public:
-  // Construct a random graph.
+  // Construct a random graph seeded from the system clock.
   RandomGraph(double edge_density, double min_distance, double max_distance)
-    : edge_density_(edge_density),
+    : RandomGraph(edge_density, min_distance, max_distance, clock_seed()) {}
+  // Construct a random graph from the given seed and stream.
+  RandomGraph(double edge_density, double min_distance, double max_distance,
+	      uint64_t seed, uint64_t stream=0)
+    : owned_context_(new TrialContext()),
+      context_(owned_context_.get()),
+      edge_density_(edge_density),
       min_distance_(min_distance),
       max_distance_(max_distance),
-      destinations_({INIT_VERTEX}),
       edges_(0),
-      graph_(Graph()),
-      seed_(chrono::system_clock::now().time_since_epoch().count()),
-      generator_(default_random_engine(seed_)),
-      distance_distribution_(uniform_real_distribution<double>(min_distance_,
-							       max_distance_)),
-      edge_distribution_(uniform_real_distribution<double>(0.0, 1.0)) {
+      generator_(Philox(seed, stream)),
+      uniform_index_(UNIFORM_BATCH) {
     get_random_graph();
   }
+  // Construct a random graph from the given seed and stream in the given
+  // trial context.  The context is reset first.
+  RandomGraph(double edge_density, double min_distance, double max_distance,
+	      uint64_t seed, uint64_t stream, TrialContext& context)
+    : context_(&context),
+      edge_density_(edge_density),
+      min_distance_(min_distance),
+      max_distance_(max_distance),
+      edges_(0),
+      generator_(Philox(seed, stream)),
+      uniform_index_(UNIFORM_BATCH) {
+    context_->reset();
+    get_random_graph();
+  }
+  // Return the size of the connected component of the given vertex.
+  int component_size(int vertex) {
+    return context_->component_size(vertex);
+  }
+  // Return whether all vertices are reachable from INIT_VERTEX.
+  bool connected() { return component_size(INIT_VERTEX) == MAX_VERTICES; }
+  // Return the number of destinations, i.e. vertices with edges, plus
+  // INIT_VERTEX.
+  int destinations() const;
+  // Return total amount of edges.
+  int edges() const { return edges_; }
   // Compute shortest-path distances from INIT_VERTEX.  Return
   // destination-to-distance map in the following format:
   // {{destination 1, SP distance 1}, ..., {destination i, SP distance i}}
   unordered_map<int, double> shortest_paths();
+  // Compute shortest-path distances from INIT_VERTEX into the trial
+  // context and return them indexed by vertex.  Unreachable vertices get
+  // NO_PATH.
+  const vector<double>& shortest_path_distances() {
+    return context_->shortest_path_distances(INIT_VERTEX);
+  }
+  // Replace the graph by a new one drawn from the rest of the random
+  // stream, e.g. to resample a disconnected graph.
+  void resample() {
+    context_->reset();
+    edges_ = 0;
+    get_random_graph();
+  }
 
  private:
-  // Generate a random graph.
+  // Generate a random graph.  Instead of drawing every vertex pair, the
+  // method draws the number of absent pairs before the next edge, which
+  // is geometrically distributed.  The cost is proportional to the number
+  // of edges (Batagelj & Brandes, Efficient generation of large random
+  // networks, 2005).  Edges are also joined in the union-find of the
+  // context.
   void get_random_graph();
   // Return random distance.
-  double random_distance() { return distance_distribution_(generator_); }
-  // Randomly pick an edge based on edge density.
-  bool random_edge() { return edge_distribution_(generator_) < edge_density_; }
-  // Destination sets.
-  unordered_set<int> destinations_;
+  double random_distance() {
+    return min_distance_ + (max_distance_ - min_distance_) * random_uniform();
+  }
+  // Return random number of vertex pairs to skip before the next edge.
+  double random_skip();
+  // Return random uniform in [0, 1) from the current batch.  Refill the
+  // batch when it is used up.
+  double random_uniform() {
+    vector<double>& uniforms = context_->uniforms();
+    if(uniform_index_ == UNIFORM_BATCH) {
+      generator_.fill_uniform(uniforms.data(), UNIFORM_BATCH);
+      uniform_index_ = 0;
+    }
+    return uniforms[uniform_index_++];
+  }
+  // Trial context owned by this random graph, if any.
+  unique_ptr<TrialContext> owned_context_;
+  // Trial context holding the graph.
+  TrialContext* context_;
   // Edge density.
   double edge_density_;
   // Total amount of edges.
   int edges_;
-  // Undirected graph.
-  Graph graph_;
   // Maximum distance.
   double max_distance_;
   // Minimum distance.
   double min_distance_;
-  // Seed for random number generator.
-  unsigned seed_;
   // Random generator.
-  default_random_engine generator_;
-  // Uniform distribution for distances.
-  uniform_real_distribution<double> distance_distribution_;
-  // Uniform distribution for edges.
-  uniform_real_distribution<double> edge_distribution_;
+  Philox generator_;
+  // Index of next uniform in the batch.
+  int uniform_index_;
 }; 
 
+// A streaming sketch to estimate quantiles of non-negative values with
+// bounded relative error (Masson et al., DDSketch, VLDB 2019).  Positive
+// values fall into logarithmic buckets (gamma^(k-1), gamma^k], so any
+// quantile estimate is within the relative accuracy of a value of the
+// data.  Sketches with the same accuracy merge exactly by adding their
+// bucket counts.
+class QuantileSketch {
+ public:
+  // Construct a sketch with the given relative accuracy.
+  QuantileSketch(double accuracy=0.01)
+    : gamma_((1.0 + accuracy) / (1.0 - accuracy)),
+      inverse_log_gamma_(1.0 / log(gamma_)),
+      offset_(0),
+      total_(0),
+      zeros_(0) {}
+  // Add value data point.
+  void add(double value);
+  // Remove all data points.  The buckets are kept and zeroed, so a
+  // sketch reused for data of the same range does not allocate.
+  void clear();
+  // Merge data points of another sketch with the same accuracy.
+  void merge(const QuantileSketch& other);
+  // Return estimate of the given quantile in [0, 1].  Return 0 if there
+  // are no data points.
+  double quantile(double q) const;
+  // Read sketch in binary from the stream.
+  void read(istream& in);
+  // Make the buckets of all positive values from min_value to max_value
+  // available, so that adding them does not allocate.
+  void reserve(double min_value, double max_value);
+  // Return total number of data points.
+  long size() const { return total_; }
+  // Write sketch in binary to the stream.
+  void write(ostream& out) const;
+ private:
+  // Return bucket index of the given positive value.
+  int bucket(double value) const {
+    return ceil(log(value) * inverse_log_gamma_);
+  }
+  // Make bucket of the given index available.
+  void grow(int index);
+  // Bucket counts, starting with bucket index offset_.
+  vector<long> counts_;
+  // Bucket growth factor.
+  double gamma_;
+  // Reciprocal of log(gamma_).
+  double inverse_log_gamma_;
+  // Bucket index of counts_[0].
+  int offset_;
+  // Total number of data points.
+  long total_;
+  // Number of zero data points.
+  long zeros_;
+};
+
 // A class to collect and compute shortest-path distance statistics.
+// Mean and variance are updated with Welford's method, and statistics
+// collected separately merge as if all data points were added to one
+// instance (Chan et al., Algorithms for computing the sample variance,
+// 1983).
 class SPDistanceStats {
  public:
   // Construct a satistics instance.
   SPDistanceStats()
-    : sum_(0.0), total_(0) {}
+    : m2_(0.0), mean_(0.0), total_(0) {}
   // Add distance data point.
   void add(double distance) {
-    sum_ += distance;
+    double delta = distance - mean_;
     total_++;
+    mean_ += delta / total_;
+    m2_ += delta * (distance - mean_);
+    sketch_.add(distance);
+  }
+  // Remove all data points, keeping the buckets of the sketch.
+  void clear() {
+    m2_ = mean_ = 0.0;
+    total_ = 0;
+    sketch_.clear();
   }
   // Compute average.
-  double average() {
+  double average() const {
     if(total_)
-      return sum_ / total_;
+      return mean_;
     return 0.0;
   }
+  // Return half width of the 95% confidence interval of the average,
+  // using the normal approximation.
+  double confidence_interval() const {
+    if(total_ < 2)
+      return 0.0;
+    return 1.96 * sqrt(variance() / total_);
+  }
+  // Merge data points of another statistics instance.
+  void merge(const SPDistanceStats& other);
+  // Return estimate of the given quantile of the distances.
+  double quantile(double q) const { return sketch_.quantile(q); }
+  // Read statistics in binary from the stream.
+  void read(istream& in);
+  // Make the sketch ready for distances in the given range without
+  // allocation.
+  void reserve(double min_distance, double max_distance) {
+    sketch_.reserve(min_distance, max_distance);
+  }
+  // Return total number of distance data points.
+  long size() const { return total_; }
+  // Return sample variance.
+  double variance() const {
+    if(total_ < 2)
+      return 0.0;
+    return m2_ / (total_ - 1);
+  }
+  // Write statistics in binary to the stream.
+  void write(ostream& out) const;
  private:
-  // Sum of distances.
-  double sum_;
+  // Sum of squared deviations from the mean.
+  double m2_;
+  // Mean of distances.
+  double mean_;
+  // Sketch of distance quantiles.
+  QuantileSketch sketch_;
   // Total number of distance data points.
-  int total_;
+  long total_;
+};
+
+// Add shortest-path distances indexed by vertex to the statistics of
+// each destination.  Unreachable vertices are skipped.
+void add_path_distances(const vector<double>& distances,
+			vector<SPDistanceStats>& stats);
+
+// Return average path distances over all shortest paths, given the
+// statistics of each destination.
+double average_path_distance(const vector<SPDistanceStats>& stats);
+
+// Run chunk_function(chunk, context) for chunks 0 to chunks-1 on worker
+// threads.  Workers take chunks in turn, and each owns a trial context
+// that it passes to all of its chunks.  If threads is 0, use the number
+// of hardware threads.
+void run_chunks(int chunks, int threads,
+		const function<void(int, TrialContext&)>& chunk_function);
+
+// Statistics collected by simulation trials.  Phase times are summed
+// over worker threads and are not saved in checkpoints.
+struct SimulationStats {
+  // Construct empty statistics.
+  SimulationStats()
+    : aggregate_seconds(0.0),
+      destinations(MAX_VERTICES),
+      generate_seconds(0.0),
+      resamples(0),
+      sssp_seconds(0.0) {}
+  // Remove all statistics, keeping the storage for reuse.
+  void clear();
+  // Merge statistics of other trials.
+  void merge(const SimulationStats& other);
+  // Read statistics in binary from the stream.
+  void read(istream& in);
+  // Make the statistics ready for path distances of edges in the given
+  // range, and for all component sizes, without allocation.
+  void reserve(double min_distance, double max_distance);
+  // Write statistics in binary to the stream.
+  void write(ostream& out) const;
+  // Seconds spent adding trial results to the statistics.
+  double aggregate_seconds;
+  // Statistics of each destination.
+  vector<SPDistanceStats> destinations;
+  // Seconds spent generating trial graphs, including resamples.
+  double generate_seconds;
+  // Number of graphs resampled for being disconnected.
+  long resamples;
+  // Statistics of the sizes of the source components.
+  SPDistanceStats source_components;
+  // Seconds spent solving single-source shortest paths.
+  double sssp_seconds;
+  // Statistics of per-trial average path distances.
+  SPDistanceStats trials;
 };
 
 // A class to simulate and run multiple trials of shortest-path
-// computation in random graphs.
+// computation in random graphs.  Trials are split into chunks of
+// TRIAL_CHUNK trials, which worker threads take in turn.  Every trial
+// draws its random graph from the Philox stream of its trial number
+// under the simulation seed, and every chunk collects its own
+// statistics.  The chunk statistics are merged in chunk order, so the
+// results for a given seed do not depend on the number of threads.
+//
+// With a target width, the simulation stops early once the 95%
+// confidence interval of the mean per-trial average path distance is
+// narrower than the target relative to the mean.  The check runs after
+// merging each chunk in chunk order, so the stopping trial does not
+// depend on the number of threads either, and trials then bounds the
+// number of trials.
+//
+// In batched mode, the trials of a chunk are solved BATCH_LANES at a time
+// by BatchedDijkstra instead of one by one.  The results are the same.
+//
+// Trial graphs are RandomGraph instances unless a graph generator is
+// set, which then draws each trial graph from the same Philox stream.
+// Each trial records the size of the component of INIT_VERTEX.  With
+// resampling, disconnected graphs are redrawn from the rest of the
+// stream of the trial, up to MAX_RESAMPLES times, so the statistics are
+// conditioned on connected graphs.
+//
+// With a checkpoint file, the simulation saves its statistics and the
+// number of trials run after every few chunks.  Trial graphs depend only
+// on the seed and the trial number, so these are all the state needed,
+// and resume() continues a run exactly where its last checkpoint left
+// off: with the same seed, a resumed run gives the same results as an
+// uninterrupted one.  With a target width, both stop at the same trial,
+// since the stopping check runs after every chunk in chunk order.
+//
+// write_report() writes the results in JSON or CSV, with the statistics
+// of every destination, the time spent in each phase of the trials and
+// the throughput of the last run().
 class Simulation {
  public:
-  // Construct a simulation instance.
+  // Construct a simulation instance.  If threads is 0, use the number
+  // of hardware threads.
   Simulation(double edge_density, double min_distance,
-	     double max_distance, int trials)
-    : edge_density_(edge_density),
+	     double max_distance, int trials,
+	     unsigned seed=clock_seed(), int threads=0)
+    : checkpoint_chunks_(0),
+      edge_density_(edge_density),
+      generator_(nullptr),
       max_distance_(max_distance),
       min_distance_(min_distance),
-      stats_(vector<SPDistanceStats>(MAX_VERTICES)),
-      trials_(trials) {}
+      seed_(seed),
+      batched_(false),
+      resample_(false),
+      resumed_trials_(0),
+      run_seconds_(0.0),
+      target_width_(0.0),
+      threads_(threads),
+      trials_(trials),
+      trials_run_(0) {}
+  // Return average path distances over all shortest paths.
+  double average() const {
+    return average_path_distance(stats_.destinations);
+  }
+  // Return the random graph of the given trial.  This replays a single
+  // trial in isolation.
+  RandomGraph trial_graph(int trial) {
+    return RandomGraph(edge_density_, min_distance_, max_distance_, seed_,
+		       trial);
+  }
   // Run simulation and collect statistics.
   void run();
   // Print simulation results.
   void print();
+  // Resume from the given checkpoint file.  Return false, and keep the
+  // state, if the file does not exist, is not a complete checkpoint of
+  // this version, or was written by a simulation with other settings.
+  // A run may be extended by resuming it with more trials.
+  bool resume(const string& filename);
+  // Write a checkpoint to the given file after every given number of
+  // trials, rounded up to whole chunks, and at the end of the run.
+  void set_checkpoint(const string& filename, int trials) {
+    checkpoint_file_ = filename;
+    checkpoint_chunks_ = max(1, (trials + TRIAL_CHUNK - 1) / TRIAL_CHUNK);
+  }
+  // Redraw disconnected trial graphs.
+  void set_resample(bool resample) { resample_ = resample; }
+  // Solve trials in batches with BatchedDijkstra.
+  void set_batched(bool batched) { batched_ = batched; }
+  // Generate trial graphs with the given generator of MAX_VERTICES
+  // vertices, which must outlive the simulation.  The edge density of
+  // the simulation is then unused.
+  void set_generator(const GraphGenerator* generator) {
+    assert(generator->vertices() == MAX_VERTICES);
+    generator_ = generator;
+  }
+  // Stop once the relative width of the confidence interval is below the
+  // given target, e.g. 0.01 for 1%.  A target of 0 runs all trials.
+  void set_target_width(double target_width) {
+    target_width_ = target_width;
+  }
+  // Return statistics of the simulation.
+  const SimulationStats& stats() const { return stats_; }
+  // Return statistics of per-trial average path distances.
+  const SPDistanceStats& trial_stats() const { return stats_.trials; }
+  // Return the number of trials run.
+  int trials_run() const { return trials_run_; }
+  // Return trials per second of wall-clock time in the last run(),
+  // excluding trials restored from a checkpoint.
+  double trials_per_second() const {
+    if(run_seconds_ <= 0.0)
+      return 0.0;
+    return (trials_run_ - resumed_trials_) / run_seconds_;
+  }
+  // Write the CSV header line of write_report().
+  static void write_csv_header(ostream& out);
+  // Write simulation results in the given format.  JSON is one object on
+  // a line.  CSV is one line per destination without the header.
+  void write_report(ostream& out, ReportFormat format) const;
  private:
-  // Return average path distances over all shortest paths.
-  double average();
-  // Process results of shortest-path computation in random graph.
-  void process_results(unordered_map<int, double>& results);
-  // Index for vertex.
-  int index(int vertex) { return vertex - INIT_VERTEX; }
+  // Write a checkpoint.  The file is replaced atomically, so a run killed
+  // while writing keeps its previous checkpoint.  Return false if the
+  // file cannot be written.
+  bool checkpoint();
+  // Add shortest-path distances of a trial, which are indexed by vertex,
+  // and the size of its source component to the statistics.
+  void add_trial(const vector<double>& distances, int component_size,
+		 SimulationStats& stats);
+  // Return whether the confidence interval is narrow enough to stop.
+  bool converged() const;
+  // Generate the graph of the given trial in the given context and
+  // return the size of its source component.  Count resamples in the
+  // statistics.
+  int generate_trial(int trial, TrialContext& context,
+		     SimulationStats& stats);
+  // Return the description of the graph generator, or an empty string
+  // for RandomGraph.
+  string generator_description() const {
+    return generator_ ? generator_->description() : string();
+  }
+  // Run trials of the given chunk in the given context and collect
+  // their statistics.
+  void run_chunk(int chunk, TrialContext& context, SimulationStats& stats);
+  // Chunks between checkpoints.
+  int checkpoint_chunks_;
+  // Checkpoint file, or empty if none.
+  string checkpoint_file_;
   // Edge density.
   double edge_density_;
+  // Graph generator, or nullptr for RandomGraph.
+  const GraphGenerator* generator_;
   // Maximum distance.
   double max_distance_;
   // Minimum distance.
   double min_distance_;
-  vector<SPDistanceStats> stats_;
+  // Seed of the simulation.
+  unsigned seed_;
+  // Whether to solve trials in batches.
+  bool batched_;
+  // Whether to redraw disconnected graphs.
+  bool resample_;
+  // Number of trials restored from a checkpoint.
+  int resumed_trials_;
+  // Wall-clock seconds of the last run().
+  double run_seconds_;
+  // Statistics of the trials run.
+  SimulationStats stats_;
+  // Target relative width of the confidence interval, or 0 if none.
+  double target_width_;
+  // Number of worker threads.
+  int threads_;
+  // Total number of trials.
+  int trials_;
+  // Number of trials run.
+  int trials_run_;
+};
+
+// A class to simulate shortest paths over a grid of edge densities with
+// coupled random graphs.  Every trial draws one uniform and one distance
+// per vertex pair, and the graph for density p holds the pairs whose
+// uniform is below p.  The graph for each density thus has the same law
+// as RandomGraph, while the graphs of a trial are nested across
+// densities, which lowers the variance of differences between
+// densities.  A trial adds the pairs in order of their uniforms and
+// updates shortest paths incrementally, recording the distances as each
+// grid density is passed.  Trials run in chunks like Simulation.
+class DensitySweep {
+ public:
+  // Construct a density sweep.  If threads is 0, use the number of
+  // hardware threads.
+  DensitySweep(const vector<double>& edge_densities, double min_distance,
+	       double max_distance, int trials,
+	       unsigned seed=clock_seed(), int threads=0);
+  // Return average path distances over all shortest paths for the
+  // density at the given index of the grid.
+  double average(int density_index) {
+    return average_path_distance(stats_[density_index]);
+  }
+  // Run sweep and collect statistics.
+  void run();
+  // Print sweep results.
+  void print();
+ private:
+  // Vertex pair with its uniform and distance.
+  struct SweepEdge {
+    double uniform;
+    int vertex1, vertex2;
+    double distance;
+    // Order by uniform.
+    bool operator<(const SweepEdge& other) const {
+      return uniform < other.uniform;
+    }
+  };
+  // Run trials of the given chunk in the given context and collect
+  // their statistics for each density.
+  void run_chunk(int chunk, TrialContext& context,
+		 vector<vector<SPDistanceStats> >& stats);
+  // Run a trial in the given context and collect its statistics for each
+  // density.  Edges of the trial are kept in the given vector to reuse
+  // its capacity.
+  void run_trial(int trial, TrialContext& context, vector<SweepEdge>& edges,
+		 vector<vector<SPDistanceStats> >& stats);
+  // Edge densities in ascending order.
+  vector<double> edge_densities_;
+  // Maximum distance.
+  double max_distance_;
+  // Minimum distance.
+  double min_distance_;
+  // Seed of the sweep.
+  unsigned seed_;
+  // Statistics of each destination for each density.
+  vector<vector<SPDistanceStats> > stats_;
+  // Number of worker threads.
+  int threads_;
   // Total number of trials.
   int trials_;
 };
@@ -0,0 +1,435 @@
+// Unit tests for random graph and simulation using Googletest:
+//   http://code.google.com/p/googletest/
+
+#include "random_graph.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+const double MAX_DISTANCE = 10.0;
+const double MIN_DISTANCE = 1.0;
+
+TEST(random_graph_test_suite, test_fixed_seed) {
+  RandomGraph rgraph1 = RandomGraph(0.3, MIN_DISTANCE, MAX_DISTANCE, 7);
+  RandomGraph rgraph2 = RandomGraph(0.3, MIN_DISTANCE, MAX_DISTANCE, 7);
+  unordered_map<int, double> results1 = rgraph1.shortest_paths();
+  unordered_map<int, double> results2 = rgraph2.shortest_paths();
+  EXPECT_TRUE(results1 == results2)
+    << "Random graphs with the same seed should have the same paths.";
+  EXPECT_EQ(0.0, results1[INIT_VERTEX])
+    << "Distance to the initial vertex should be 0.";
+}
+
+TEST(random_graph_test_suite, test_complete_graph) {
+  RandomGraph rgraph = RandomGraph(1.0, MIN_DISTANCE, MAX_DISTANCE, 7);
+  unordered_map<int, double> results = rgraph.shortest_paths();
+  EXPECT_EQ(MAX_VERTICES, results.size())
+    << "All vertices should be reachable in complete graph.";
+  for(auto& result: results)
+    EXPECT_LE(result.second, MAX_DISTANCE)
+      << "Distance should not exceed a direct edge.";
+}
+
+TEST(random_graph_test_suite, test_edge_count) {
+  const int pairs = MAX_VERTICES * (MAX_VERTICES - 1) / 2;
+  const int graphs = 400;
+  RandomGraph empty = RandomGraph(0.0, MIN_DISTANCE, MAX_DISTANCE, 7);
+  RandomGraph complete = RandomGraph(1.0, MIN_DISTANCE, MAX_DISTANCE, 7);
+  EXPECT_EQ(0, empty.edges()) << "Empty graph should have no edges.";
+  EXPECT_EQ(pairs, complete.edges())
+    << "Complete graph should have all " << pairs << " edges.";
+
+  // Mean edge count should be close to density times vertex pairs.
+  for(double density: { 0.05, 0.2, 0.5 }) {
+    double total = 0.0;
+    for(int seed = 0; seed < graphs; seed++) {
+      RandomGraph rgraph = RandomGraph(density, MIN_DISTANCE, MAX_DISTANCE,
+				       seed);
+      total += rgraph.edges();
+    }
+    EXPECT_NEAR(density * pairs, total / graphs, 0.02 * density * pairs)
+      << "Mean edge count is off for density: " << density;
+  }
+}
+
+TEST(random_graph_test_suite, test_reuse_trial_context) {
+  TrialContext context = TrialContext();
+  for(int stream = 0; stream < 10; stream++) {
+    RandomGraph owned = RandomGraph(0.2, MIN_DISTANCE, MAX_DISTANCE, 3,
+				    stream);
+    RandomGraph reused = RandomGraph(0.2, MIN_DISTANCE, MAX_DISTANCE, 3,
+				     stream, context);
+    EXPECT_EQ(owned.destinations(), reused.destinations())
+      << "Destinations should match for stream: " << stream;
+    EXPECT_TRUE(owned.shortest_paths() == reused.shortest_paths())
+      << "Paths should match for stream: " << stream;
+  }
+}
+
+TEST(simulation_test_suite, test_thread_count_invariance) {
+  Simulation sim1 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11, 1);
+  sim1.run();
+  for(int threads = 2; threads <= 5; threads++) {
+    Simulation sim = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11,
+				threads);
+    sim.run();
+    EXPECT_EQ(sim1.average(), sim.average())
+      << "Average should not depend on threads: " << threads;
+  }
+}
+
+TEST(simulation_test_suite, test_seed_changes_results) {
+  Simulation sim1 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  Simulation sim2 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 12);
+  sim1.run();
+  sim2.run();
+  EXPECT_NE(sim1.average(), sim2.average())
+    << "Different seeds should give different averages.";
+}
+
+TEST(simulation_test_suite, test_replay_trial) {
+  Simulation sim = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  RandomGraph replay = RandomGraph(0.2, MIN_DISTANCE, MAX_DISTANCE, 11, 42);
+  RandomGraph rgraph = sim.trial_graph(42);
+  EXPECT_EQ(replay.edges(), rgraph.edges())
+    << "Replayed trial should have the same edges.";
+  EXPECT_TRUE(replay.shortest_paths() == rgraph.shortest_paths())
+    << "Replayed trial should have the same paths.";
+}
+
+TEST(density_sweep_test_suite, test_thread_count_invariance) {
+  vector<double> densities = { 0.4, 0.1, 0.2 };
+  DensitySweep sweep1 = DensitySweep(densities, MIN_DISTANCE, MAX_DISTANCE,
+				     50, 11, 1);
+  DensitySweep sweep3 = DensitySweep(densities, MIN_DISTANCE, MAX_DISTANCE,
+				     50, 11, 3);
+  sweep1.run();
+  sweep3.run();
+  for(size_t i = 0; i < densities.size(); i++)
+    EXPECT_EQ(sweep1.average(i), sweep3.average(i))
+      << "Average should not depend on threads at index: " << i;
+}
+
+TEST(density_sweep_test_suite, test_matches_simulation) {
+  // Densities are sorted, and each density has the law of independent
+  // simulations, so averages should agree within Monte Carlo error.
+  vector<double> densities = { 0.4, 0.2 };
+  DensitySweep sweep = DensitySweep(densities, MIN_DISTANCE, MAX_DISTANCE,
+				    400, 5);
+  sweep.run();
+  EXPECT_LT(sweep.average(1), sweep.average(0))
+    << "Denser graphs should have shorter paths.";
+  for(size_t i = 0; i < densities.size(); i++) {
+    double density = i ? 0.4 : 0.2;
+    Simulation sim = Simulation(density, MIN_DISTANCE, MAX_DISTANCE, 400, 6);
+    sim.run();
+    EXPECT_NEAR(sim.average(), sweep.average(i), 0.05 * sim.average())
+      << "Sweep average is off for density: " << density;
+  }
+}
+
+TEST(sp_distance_stats_test_suite, test_merge) {
+  SPDistanceStats all, first, second;
+  for(int i = 0; i < 1000; i++) {
+    double distance = (i * 37) % 101 + 0.5;
+    all.add(distance);
+    (i < 300 ? first : second).add(distance);
+  }
+  first.merge(second);
+  EXPECT_EQ(all.size(), first.size()) << "Sizes should match.";
+  EXPECT_NEAR(all.average(), first.average(), 1e-9)
+    << "Merged average should match.";
+  EXPECT_NEAR(all.variance(), first.variance(), 1e-6)
+    << "Merged variance should match.";
+  for(double q: { 0.0, 0.1, 0.5, 0.9, 1.0 })
+    EXPECT_EQ(all.quantile(q), first.quantile(q))
+      << "Merged quantile should match at: " << q;
+}
+
+TEST(sp_distance_stats_test_suite, test_moments_and_quantiles) {
+  SPDistanceStats stats;
+  EXPECT_EQ(0.0, stats.average()) << "Empty average should be 0.";
+  EXPECT_EQ(0.0, stats.quantile(0.5)) << "Empty quantile should be 0.";
+  for(int i = 1; i <= 1000; i++)
+    stats.add(i);
+  EXPECT_NEAR(500.5, stats.average(), 1e-9) << "Average is wrong.";
+  EXPECT_NEAR(1000.0 * 1001.0 / 12.0, stats.variance(), 1e-6)
+    << "Variance is wrong.";
+  EXPECT_NEAR(500.0, stats.quantile(0.5), 500.0 * 0.01)
+    << "Median should be within 1%.";
+  EXPECT_NEAR(990.0, stats.quantile(0.99), 990.0 * 0.01)
+    << "99th percentile should be within 1%.";
+  EXPECT_NEAR(1000.0, stats.quantile(1.0), 1000.0 * 0.01)
+    << "Maximum should be within 1%.";
+}
+
+TEST(sp_distance_stats_test_suite, test_reserve_and_clear) {
+  // Reserved and reused statistics give the same quantiles as fresh ones.
+  SPDistanceStats fresh, reused;
+  reused.reserve(1.0, 1000.0);
+  for(int i = 1; i <= 10; i++)
+    reused.add(i * 7.0);
+  reused.clear();
+  EXPECT_EQ(0, reused.size()) << "Cleared statistics should be empty.";
+  EXPECT_EQ(0.0, reused.quantile(0.5)) << "Empty quantile should be 0.";
+  for(int i = 1; i <= 1000; i++) {
+    fresh.add(i);
+    reused.add(i);
+  }
+  EXPECT_EQ(fresh.average(), reused.average()) << "Average is wrong.";
+  for(double q: { 0.0, 0.01, 0.5, 0.99, 1.0 })
+    EXPECT_EQ(fresh.quantile(q), reused.quantile(q))
+      << "Quantile is wrong: " << q;
+}
+
+TEST(simulation_test_suite, test_target_width) {
+  Simulation full = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 2000, 11, 1);
+  full.run();
+  EXPECT_EQ(2000, full.trials_run()) << "All trials should run.";
+  Simulation sim1 = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 2000, 11, 1);
+  sim1.set_target_width(0.02);
+  sim1.run();
+  EXPECT_LT(sim1.trials_run(), 2000) << "Simulation should stop early.";
+  EXPECT_EQ(0, sim1.trials_run() % TRIAL_CHUNK)
+    << "Simulation should stop at a chunk boundary.";
+  EXPECT_LE(2.0 * sim1.trial_stats().confidence_interval(),
+	    0.02 * sim1.trial_stats().average())
+    << "Confidence interval should be within the target.";
+  for(int threads = 2; threads <= 4; threads++) {
+    Simulation sim = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 2000, 11,
+				threads);
+    sim.set_target_width(0.02);
+    sim.run();
+    EXPECT_EQ(sim1.trials_run(), sim.trials_run())
+      << "Stopping trial should not depend on threads: " << threads;
+    EXPECT_EQ(sim1.average(), sim.average())
+      << "Average should not depend on threads: " << threads;
+  }
+  // Checkpoints after every chunk do not move the stopping trial.
+  const char* filename = "random_graph_test_width.ckpt";
+  Simulation checkpointed = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE,
+				       2000, 11, 3);
+  checkpointed.set_target_width(0.02);
+  checkpointed.set_checkpoint(filename, TRIAL_CHUNK);
+  checkpointed.run();
+  EXPECT_EQ(sim1.trials_run(), checkpointed.trials_run())
+    << "Stopping trial should not depend on checkpoints.";
+  EXPECT_EQ(sim1.average(), checkpointed.average())
+    << "Average should not depend on checkpoints.";
+  remove(filename);
+}
+
+TEST(simulation_test_suite, test_batched) {
+  // 100 trials leave a partial batch in the last chunk.
+  for(double density: { 0.05, 0.2, 0.6 }) {
+    Simulation sim = Simulation(density, MIN_DISTANCE, MAX_DISTANCE, 100, 11,
+				2);
+    Simulation batched = Simulation(density, MIN_DISTANCE, MAX_DISTANCE, 100,
+				    11, 2);
+    batched.set_batched(true);
+    sim.run();
+    batched.run();
+    EXPECT_EQ(sim.average(), batched.average())
+      << "Batched average should match for density: " << density;
+    EXPECT_EQ(sim.trial_stats().variance(), batched.trial_stats().variance())
+      << "Batched variance should match for density: " << density;
+  }
+}
+
+TEST(random_graph_test_suite, test_components) {
+  for(int stream = 0; stream < 20; stream++) {
+    RandomGraph rgraph = RandomGraph(0.03, MIN_DISTANCE, MAX_DISTANCE, 5,
+				     stream);
+    unordered_map<int, double> results = rgraph.shortest_paths();
+    EXPECT_EQ(results.size(), rgraph.component_size(INIT_VERTEX))
+      << "Source component should be the reachable vertices in stream: "
+      << stream;
+    EXPECT_EQ(results.size() == MAX_VERTICES, rgraph.connected())
+      << "Connectivity is wrong in stream: " << stream;
+  }
+
+  // Resampling draws new graphs until the source reaches all vertices.
+  RandomGraph rgraph = RandomGraph(0.1, MIN_DISTANCE, MAX_DISTANCE, 5, 1);
+  for(int i = 0; i < 100 && !rgraph.connected(); i++)
+    rgraph.resample();
+  EXPECT_TRUE(rgraph.connected()) << "Resampled graph should be connected.";
+  EXPECT_EQ(MAX_VERTICES, rgraph.shortest_paths().size())
+    << "All vertices should be reachable.";
+}
+
+TEST(simulation_test_suite, test_average_counts_zero_distances) {
+  vector<SPDistanceStats> stats(MAX_VERTICES);
+  stats[1].add(0.0);
+  stats[2].add(2.0);
+  EXPECT_EQ(1.0, average_path_distance(stats))
+    << "Destination at distance 0 should count.";
+}
+
+TEST(simulation_test_suite, test_resample) {
+  Simulation sim = Simulation(0.05, MIN_DISTANCE, MAX_DISTANCE, 200, 11);
+  Simulation resampled = Simulation(0.05, MIN_DISTANCE, MAX_DISTANCE, 200,
+				    11);
+  resampled.set_resample(true);
+  sim.run();
+  resampled.run();
+  EXPECT_LT(sim.stats().source_components.average(), MAX_VERTICES)
+    << "Sparse graphs should be disconnected.";
+  EXPECT_EQ(0, sim.stats().resamples) << "Nothing should be resampled.";
+  EXPECT_EQ(MAX_VERTICES, resampled.stats().source_components.average())
+    << "Resampled graphs should be connected.";
+  EXPECT_LT(0, resampled.stats().resamples)
+    << "Some graphs should be resampled.";
+  EXPECT_EQ(200, resampled.stats().trials.size())
+    << "Every trial should be counted once.";
+}
+
+TEST(simulation_test_suite, test_checkpoint) {
+  const char* filename = "random_graph_test.ckpt";
+  Simulation full = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11, 2);
+  full.run();
+
+  // A run stopped after 48 trials and resumed matches one without stops.
+  Simulation first = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 48, 11, 2);
+  first.set_checkpoint(filename, 20);
+  first.run();
+  Simulation resumed = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11,
+				  2);
+  ASSERT_TRUE(resumed.resume(filename)) << "Checkpoint should be read.";
+  EXPECT_EQ(48, resumed.trials_run()) << "Trials run should be restored.";
+  resumed.set_checkpoint(filename, 20);
+  resumed.run();
+  EXPECT_EQ(100, resumed.trials_run()) << "All trials should run.";
+  EXPECT_EQ(full.average(), resumed.average())
+    << "Resumed average should match.";
+  EXPECT_EQ(full.trial_stats().variance(), resumed.trial_stats().variance())
+    << "Resumed variance should match.";
+  EXPECT_EQ(full.trial_stats().quantile(0.5),
+	    resumed.trial_stats().quantile(0.5))
+    << "Resumed median should match.";
+
+  // The final checkpoint holds the complete run.
+  Simulation done = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11);
+  ASSERT_TRUE(done.resume(filename)) << "Final checkpoint should be read.";
+  done.run();
+  EXPECT_EQ(full.average(), done.average())
+    << "Finished run should not run more trials.";
+
+  // Checkpoints of other settings are refused.
+  Simulation other_seed = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100,
+				     12);
+  EXPECT_FALSE(other_seed.resume(filename)) << "Seed should not match.";
+  Simulation other_density = Simulation(0.4, MIN_DISTANCE, MAX_DISTANCE, 100,
+					11);
+  EXPECT_FALSE(other_density.resume(filename)) << "Density should not match.";
+  Simulation fewer = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 50, 11);
+  EXPECT_FALSE(fewer.resume(filename)) << "Trials run should not fit.";
+
+  // Truncated, foreign and unwritable checkpoints fail without aborting,
+  // and a refused file leaves the simulation as it was.
+  ifstream in(filename, ios::binary);
+  string bytes = string(istreambuf_iterator<char>(in),
+			istreambuf_iterator<char>());
+  in.close();
+  for(size_t size: { size_t(0), size_t(6), size_t(40), bytes.size() - 1 }) {
+    ofstream(filename, ios::binary).write(bytes.data(), size);
+    Simulation truncated = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100,
+				      11);
+    EXPECT_FALSE(truncated.resume(filename))
+      << "Truncated file should be refused: " << size;
+    EXPECT_EQ(0, truncated.trials_run()) << "State should be kept.";
+  }
+  for(int byte: { 0, 4 }) {
+    string corrupt = bytes;
+    corrupt[byte] ^= 1;
+    ofstream(filename, ios::binary) << corrupt;
+    EXPECT_FALSE(done.resume(filename))
+      << "Wrong magic or version should be refused: " << byte;
+  }
+  remove(filename);
+  EXPECT_FALSE(done.resume(filename)) << "Missing file should be refused.";
+  Simulation unwritable = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16,
+				     11);
+  unwritable.set_checkpoint("no_such_directory/random_graph_test.ckpt", 16);
+  unwritable.run();
+  EXPECT_EQ(16, unwritable.trials_run())
+    << "Run should go on without checkpoints.";
+}
+
+TEST(simulation_test_suite, test_checkpoint_generator) {
+  const char* filename = "random_graph_generator_test.ckpt";
+  BarabasiAlbertGenerator ba = BarabasiAlbertGenerator(MAX_VERTICES, 2,
+							MIN_DISTANCE,
+							MAX_DISTANCE);
+  Simulation first = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16, 11);
+  first.set_generator(&ba);
+  first.set_checkpoint(filename, 16);
+  first.run();
+
+  // Only a simulation of the same generator and parameters resumes.
+  Simulation same = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16, 11);
+  same.set_generator(&ba);
+  EXPECT_TRUE(same.resume(filename)) << "Same generator should resume.";
+  RmatGenerator rmat = RmatGenerator(MAX_VERTICES, 200, MIN_DISTANCE,
+				     MAX_DISTANCE);
+  Simulation other_model = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16,
+				      11);
+  other_model.set_generator(&rmat);
+  EXPECT_FALSE(other_model.resume(filename)) << "Model should not match.";
+  BarabasiAlbertGenerator denser = BarabasiAlbertGenerator(MAX_VERTICES, 3,
+							    MIN_DISTANCE,
+							    MAX_DISTANCE);
+  Simulation other_degree = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16,
+				       11);
+  other_degree.set_generator(&denser);
+  EXPECT_FALSE(other_degree.resume(filename)) << "Degree should not match.";
+  Simulation random_graph = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 16,
+				       11);
+  EXPECT_FALSE(random_graph.resume(filename))
+    << "RandomGraph should not resume a generator run.";
+  EXPECT_EQ(0, random_graph.trials_run()) << "State should be kept.";
+  remove(filename);
+}
+
+TEST(simulation_test_suite, test_report) {
+  Simulation sim = Simulation(0.2, MIN_DISTANCE, MAX_DISTANCE, 100, 11, 2);
+  sim.run();
+  EXPECT_LT(0.0, sim.trials_per_second()) << "Throughput should be set.";
+  EXPECT_LT(0.0, sim.stats().generate_seconds)
+    << "Generation should be timed.";
+  EXPECT_LT(0.0, sim.stats().sssp_seconds) << "SSSP should be timed.";
+
+  // JSON is one line with the results and all destinations.
+  ostringstream json;
+  sim.write_report(json, ReportFormat::JSON);
+  string text = json.str();
+  EXPECT_EQ(1, count(text.begin(), text.end(), '\n'))
+    << "JSON should be one line.";
+  EXPECT_NE(string::npos, text.find("\"trials_per_second\": "))
+    << "JSON should report throughput.";
+  EXPECT_EQ(MAX_VERTICES - 1, count(text.begin(), text.end(), '{') - 2)
+    << "JSON should hold every destination.";
+
+  // CSV rows have as many fields as the header.
+  ostringstream csv;
+  Simulation::write_csv_header(csv);
+  sim.write_report(csv, ReportFormat::CSV);
+  istringstream lines(csv.str());
+  string header, line;
+  getline(lines, header);
+  int rows = 0;
+  while(getline(lines, line)) {
+    EXPECT_EQ(count(header.begin(), header.end(), ','),
+	      count(line.begin(), line.end(), ','))
+      << "Field count is wrong in row: " << rows;
+    rows++;
+  }
+  EXPECT_EQ(MAX_VERTICES - 1, rows) << "CSV should hold every destination.";
+}
@@ -1,20 +1,20 @@
 #include "hex_game.h"
+#include "philox.h"
 
 #include <algorithm>
-#include <chrono>
 #include <cstdlib>
 #include <iostream>
-#include <random>
 #include <string>
 
 using namespace std;
 const int TRIALS = 3;
+const uint64_t SEED = 2013;
 
 int main() {
   vector<int> keys = { 0, 1, 2, 3, 4, 5 };
-  unsigned seed = chrono::system_clock::now().time_since_epoch().count();
   for(int i=0; i < TRIALS; i++) {
-    shuffle(keys.begin(), keys.end(), default_random_engine(seed));
+    Philox generator(SEED, i);
+    shuffle(keys.begin(), keys.end(), generator);
 
     cout << "Trial: " << i+1 << endl;
     for(auto key: keys)
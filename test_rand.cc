@@ -1,12 +1,13 @@
-#include <chrono>
+#include "philox.h"
+
 #include <iostream>
 #include <random>
 
 using namespace std;
+const uint64_t SEED = 2013;
 
 int main() {
-  unsigned seed = chrono::system_clock::now().time_since_epoch().count();
-  default_random_engine generator(seed);
+  Philox generator(SEED);
   uniform_real_distribution<double> distribution(0.0, 1.0);
   cout << "some random numbers between 0.0 and 1.0: ";
   for (int i = 0; i < 10; i++)
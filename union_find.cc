@@ -2,6 +2,7 @@
 
 #include "union_find.h"
 
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -10,19 +11,83 @@ using namespace std;
 //  UnionFind
 // ===========
 
+// Construct a union-find data instance of the given fixed universe.
+UnionFind::UnionFind(Vertex universe, FindPolicy policy)
+  : components_(0), fixed_(true), policy_(policy), vertices_(universe) {
+  clear();
+}
+
+// Add a given new vertex and the missing vertices before it.  Vertices
+// of a fixed universe must be in it.
+void UnionFind::add_vertex(Vertex vertex) {
+  if(vertex < 0) {
+    for(Vertex v = -1 - negatives_.size(); v >= vertex; v--) {
+      negatives_.push_back(RootRank{ v, 0, 1 });
+      components_++;
+    }
+    return;
+  }
+  assert(!fixed_);
+  for(Vertex v = vertices_.size(); v <= vertex; v++) {
+    vertices_.push_back(RootRank{ v, 0, 1 });
+    components_++;
+  }
+}
+
+// Remove all vertices, or reset them to singletons for a fixed universe.
+void UnionFind::clear() {
+  negatives_.clear();
+  components_ = 0;
+  if(!fixed_) {
+    vertices_.clear();
+    return;
+  }
+  for(Vertex v = 0; v < Vertex(vertices_.size()); v++)
+    vertices_[v] = RootRank{ v, 0, 1 };
+  components_ = vertices_.size();
+}
+
 // Return the root vertex of a given vertex.
 Vertex UnionFind::find(Vertex vertex) {
 
   // Add new vertex.
-  if(!vertex_map_.count(vertex)) {
-    RootRank rr = { vertex, 0 };
-    vertex_map_.emplace(vertex, rr);
+  if(!contains(vertex)) {
+    add_vertex(vertex);
     return vertex;
   }
-  Vertex root = vertex_map_[vertex].root;
-  if(vertex_map_[root].root == root)
+  Vertex root = root_rank(vertex).root;
+  if(root_rank(root).root == root)
     return root;
-  return path_compression(vertex);
+  switch(policy_) {
+  case FindPolicy::PATH_HALVING:
+    return path_halving(vertex);
+  case FindPolicy::PATH_SPLITTING:
+    return path_splitting(vertex);
+  default:
+    return path_compression(vertex);
+  }
+}
+
+// Store the root of each of the given vertices.  The entry of the vertex
+// 2 * FIND_PREFETCH ahead is prefetched, and by the time the vertex
+// FIND_PREFETCH ahead comes up for its second stage, its entry is in
+// cache and the entry of its parent is prefetched.  Most paths are
+// short after compression, so most finds then hit the cache.
+void UnionFind::find_many(const Vertex* vertices, int count,
+			  Vertex* roots) {
+
+  // Add new vertices first, as growth would move the entries.
+  for(int i = 0; i < count; i++)
+    if(!contains(vertices[i]))
+      add_vertex(vertices[i]);
+  for(int i = 0; i < count; i++) {
+    if(i + 2 * FIND_PREFETCH < count)
+      __builtin_prefetch(&root_rank(vertices[i + 2 * FIND_PREFETCH]));
+    if(i + FIND_PREFETCH < count)
+      __builtin_prefetch(
+	&root_rank(root_rank(vertices[i + FIND_PREFETCH]).root));
+    roots[i] = find(vertices[i]);
+  }
 }
 
 // Join a pair of vertices.
@@ -33,28 +98,140 @@ void UnionFind::join(Vertex vertex1, Vertex vertex2) {
   // Do nothing if both vertices share the same root.
   if(root1 == root2)
     return;
-  
+  link(root1, root2);
+}
+
+// Join the given pairs of vertices in order.  The roots of all endpoints
+// are found in one batch first.  Earlier pairs of the batch may have
+// linked those roots since, so each pair finds again from them, which
+// is short and in cache.
+int UnionFind::join_many(const pair<Vertex, Vertex>* pairs, int count,
+			 bool* linked) {
+  int links = 0;
+
+  batch_roots_.resize(2 * count);
+  for(int i = 0; i < count; i++) {
+    batch_roots_[2 * i] = pairs[i].first;
+    batch_roots_[2 * i + 1] = pairs[i].second;
+  }
+  find_many(batch_roots_.data(), 2 * count, batch_roots_.data());
+  for(int i = 0; i < count; i++) {
+    Vertex root1 = find(batch_roots_[2 * i]);
+    Vertex root2 = find(batch_roots_[2 * i + 1]);
+    if(linked)
+      linked[i] = root1 != root2;
+    if(root1 == root2)
+      continue;
+    link(root1, root2);
+    links++;
+  }
+  return links;
+}
+
+// Link two distinct roots and merge their sizes.  The rank of the new
+// root grows only when both ranks are equal, so that ranks bound the
+// tree heights.
+void UnionFind::link(Vertex root1, Vertex root2) {
+
   // Ensure root1 has larger rank.
-  if(vertex_map_[root2].rank > vertex_map_[root1].rank) {
+  if(root_rank(root2).rank > root_rank(root1).rank) {
     Vertex temp = root1;
     root1 = root2;
     root2 = temp;
   }
-  vertex_map_[root2].root = root1;
-  vertex_map_[root1].rank++;
+  RootRank& rr1 = root_rank(root1);
+  RootRank& rr2 = root_rank(root2);
+  if(merge_hook_)
+    merge_hook_(rr1.size, rr2.size);
+  rr2.root = root1;
+  if(rr2.rank == rr1.rank)
+    rr1.rank++;
+  rr1.size += rr2.size;
+  components_--;
 }
 
-// Perform path compression.
+// Perform path compression in two passes: find the root, then point
+// every vertex on the path to it.
 Vertex UnionFind::path_compression(Vertex vertex) {
-  Vertex root = vertex_map_[vertex].root;
-  vector<Vertex> updates = { vertex };
+  Vertex root = root_rank(vertex).root;
 
-  // Get a vector of vertices whose roots need to be updated.
-  while(vertex_map_[root].root != root) {
-    updates.push_back(root);
-    root = vertex_map_[root].root;
+  while(root_rank(root).root != root)
+    root = root_rank(root).root;
+  while(vertex != root) {
+    RootRank& rr = root_rank(vertex);
+    vertex = rr.root;
+    rr.root = root;
   }
-  for(auto& v: updates)
-    vertex_map_[v].root = root;
   return root;
 }
+
+// Perform path halving: each visited vertex skips to its grandparent,
+// and the walk continues from there.
+Vertex UnionFind::path_halving(Vertex vertex) {
+  RootRank* rr = &root_rank(vertex);
+
+  while(rr->root != vertex) {
+    rr->root = root_rank(rr->root).root;
+    vertex = rr->root;
+    rr = &root_rank(vertex);
+  }
+  return vertex;
+}
+
+// Perform path splitting: each vertex on the path is pointed to its
+// grandparent, and the walk continues from its old parent.
+Vertex UnionFind::path_splitting(Vertex vertex) {
+  RootRank* rr = &root_rank(vertex);
+
+  while(rr->root != vertex) {
+    Vertex parent = rr->root;
+    rr->root = root_rank(parent).root;
+    vertex = parent;
+    rr = &root_rank(vertex);
+  }
+  return vertex;
+}
+
+// ===================
+//  RollbackUnionFind
+// ===================
+
+// Reset all vertices to singletons and clear the undo log.
+void RollbackUnionFind::clear() {
+  for(Vertex index = 0; index < Vertex(roots_.size()); index++)
+    roots_[index] = RootRank{ index, 0, 0 };
+  log_.clear();
+}
+
+// Join a pair of vertices by rank and log the union.
+bool RollbackUnionFind::join(Vertex vertex1, Vertex vertex2) {
+  Vertex root1 = find(vertex1) + virtual_vertices_;
+  Vertex root2 = find(vertex2) + virtual_vertices_;
+
+  // Do nothing if both vertices share the same root.
+  if(root1 == root2)
+    return false;
+
+  // Ensure root1 has larger rank.
+  if(roots_[root2].rank > roots_[root1].rank)
+    swap(root1, root2);
+  roots_[root2].root = root1;
+  bool rank_grew = roots_[root2].rank == roots_[root1].rank;
+  if(rank_grew)
+    roots_[root1].rank++;
+  log_.push_back(Union{ root2, rank_grew });
+  return true;
+}
+
+// Undo all unions since the given mark, latest first.
+void RollbackUnionFind::rollback(int checkpoint) {
+  assert(0 <= checkpoint && checkpoint <= int(log_.size()));
+  while(int(log_.size()) > checkpoint) {
+    Union& last = log_.back();
+    Vertex parent = roots_[last.child].root;
+    if(last.rank_grew)
+      roots_[parent].rank--;
+    roots_[last.child].root = last.child;
+    log_.pop_back();
+  }
+}
@@ -4,45 +4,205 @@
 #define UNION_FIND_H_
 
 #include <assert.h>
-#include <unordered_map>
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 typedef long Vertex;
 
-// RootRank encapsulates the root & rank of a vertex in union-find.
+const int FIND_PREFETCH = 16;  // Prefetch distance of find_many().
+
+// RootRank encapsulates the root & rank of a vertex in union-find, and
+// for a root of UnionFind, the size of its component.  The size fills
+// the padding after the rank, so entries stay 16 bytes.
 struct RootRank {
   Vertex root;
   uint32_t rank;
-  // For equality check.
+  uint32_t size;
+  // For equality check of root & rank.
   bool operator==(const RootRank& other) const {
     return this->root == other.root && this->rank == other.rank;
   }
 };
 
+// Policies of shortening the path from a vertex to its root in a find.
+// - FULL_COMPRESSION points every vertex on the path to the root, in two
+//   passes.
+// - PATH_HALVING points every other vertex on the path to its
+//   grandparent, in one pass.
+// - PATH_SPLITTING points every vertex on the path to its grandparent, in
+//   one pass.
+// All keep the inverse-Ackermann bound with union by rank, and none
+// allocates.
+enum class FindPolicy { FULL_COMPRESSION, PATH_HALVING, PATH_SPLITTING };
+
+// Union-find with union by rank and path shortening by a find policy.
+// Vertices are dense ids indexing a vector, so a find costs no hashing.
+// Negative vertices, such as the virtual border vertices of a hex board,
+// live in a small side table indexed by -1 - vertex.  A default instance
+// grows on demand: finding a new vertex adds it and any missing vertices
+// between it and the existing ones as singletons.  An instance of fixed
+// universe holds the vertices 0 to universe - 1 from the start, and
+// clear() resets them to singletons without freeing memory.
+//
+// Each root keeps the size of its component and the instance keeps the
+// number of components, which joins update in O(1), so find does no
+// extra work.  Both are queried only for a fixed universe, as growth adds
+// vertices the caller never touched.  A merge hook, if set, sees the sizes of the components of
+// every join that links two of them.
+//
+// find_many() and join_many() serve batches of operations on universes
+// far beyond the cache.  They prefetch the entries of the vertices a
+// few finds ahead, and then the entries of their parents, so the cache
+// misses of a batch overlap instead of forming one dependent chain.
 class UnionFind {
  public:
-  // Construct a union-find data instance.
-  UnionFind() : vertex_map_({}) {}
-  // Copy constructor of union-find class, which performs deep copy
-  // of the vertex map.
-  UnionFind(const UnionFind& uf) : vertex_map_(uf.vertex_map_) {} 
+  // Hook called with the sizes of two components before they merge:
+  // first that of the new root, then that of the other root.
+  typedef function<void(Vertex, Vertex)> MergeHook;
+  // Construct a union-find data instance that grows on demand.
+  UnionFind(FindPolicy policy=FindPolicy::FULL_COMPRESSION)
+    : components_(0), fixed_(false), policy_(policy) {}
+  // Construct a union-find data instance of the given fixed universe.
+  explicit UnionFind(Vertex universe,
+		     FindPolicy policy=FindPolicy::FULL_COMPRESSION);
+  // Remove all vertices, or reset them to singletons for a fixed
+  // universe.
+  void clear();
+  // Return the number of components of a fixed universe, including
+  // the negative vertices added.
+  Vertex component_count() const {
+    assert(fixed_);
+    return components_;
+  }
+  // Return the size of the component of a given vertex of a fixed
+  // universe.
+  Vertex component_size(Vertex vertex) {
+    assert(fixed_);
+    return root_rank(find(vertex)).size;
+  }
   // Return the root vertex of a given vertex.
   Vertex find(Vertex vertex);
+  // Store the root of each of the given vertices in roots, which may be
+  // the same array.
+  void find_many(const Vertex* vertices, int count, Vertex* roots);
   // Return RootRank of a given vertex.  Mainly for debugging.
   RootRank get_root_rank(Vertex vertex) {
-    assert(vertex_map_.count(vertex));
-    return vertex_map_[vertex];
+    assert(contains(vertex));
+    return root_rank(vertex);
   }
   // Join a pair of vertices.
   void join(Vertex vertex1, Vertex vertex2);
+  // Join the given pairs of vertices in order, as join() would.  Return
+  // the number of pairs that were in different sets, and flag them in
+  // linked if given, e.g. the edges that Kruskal's algorithm accepts.
+  int join_many(const pair<Vertex, Vertex>* pairs, int count,
+		bool* linked=nullptr);
+  // Set hook called on each merge, or clear it with an empty hook.
+  void set_merge_hook(const MergeHook& hook) { merge_hook_ = hook; }
 
  private:
+  // Add a given new vertex and the missing vertices before it.
+  void add_vertex(Vertex vertex);
+  // Return whether a given vertex exists.
+  bool contains(Vertex vertex) const {
+    if(vertex < 0)
+      return -1 - vertex < Vertex(negatives_.size());
+    return vertex < Vertex(vertices_.size());
+  }
   // Perform path compression starting from the given vertex.  Return
   // the ultimate root after completing the path compresion.
   Vertex path_compression(Vertex vertex);
-  // Vertex-to-RootRank mapping.
-  unordered_map<Vertex, RootRank> vertex_map_;
+  // Perform path halving starting from the given vertex.  Return the
+  // root.
+  Vertex path_halving(Vertex vertex);
+  // Perform path splitting starting from the given vertex.  Return the
+  // root.
+  Vertex path_splitting(Vertex vertex);
+  // Return RootRank of a given existing vertex.
+  RootRank& root_rank(Vertex vertex) {
+    return vertex < 0 ? negatives_[-1 - vertex] : vertices_[vertex];
+  }
+  // Link two distinct roots by rank.
+  void link(Vertex root1, Vertex root2);
+  // Roots of the endpoints of join_many(), kept to avoid allocation.
+  vector<Vertex> batch_roots_;
+  // Number of components.
+  Vertex components_;
+  // Whether the universe is fixed.
+  bool fixed_;
+  // Hook called on each merge, if set.
+  MergeHook merge_hook_;
+  // RootRank of negative vertices, indexed by -1 - vertex.
+  vector<RootRank> negatives_;
+  // Find policy.
+  FindPolicy policy_;
+  // RootRank of non-negative vertices, indexed by vertex.
+  vector<RootRank> vertices_;
+};
+
+// Union-find with union by rank and no path compression, which logs
+// every union so that it can be undone.  checkpoint() marks the current
+// state and rollback() undoes all unions since a mark, in O(1) per union,
+// so search algorithms can try moves and take them back without copying.
+// Without path compression a find costs O(log n).  The universe is
+// fixed: vertices 0 to universe - 1, plus the virtual vertices -1 to
+// -virtual_vertices.
+class RollbackUnionFind {
+ public:
+  // Construct a union-find of the given universe and number of virtual
+  // vertices.  Each logged union merges two sets, so the log is reserved
+  // for all of them and joins never allocate.
+  explicit RollbackUnionFind(Vertex universe, Vertex virtual_vertices=0)
+    : roots_(universe + virtual_vertices),
+      virtual_vertices_(virtual_vertices) {
+    log_.reserve(roots_.size());
+    clear();
+  }
+  // Return mark of the current state for rollback().
+  int checkpoint() const { return log_.size(); }
+  // Reset all vertices to singletons and clear the undo log.
+  void clear();
+  // Return the root vertex of a given vertex.
+  Vertex find(Vertex vertex) const {
+    Vertex index = to_index(vertex);
+    while(roots_[index].root != index)
+      index = roots_[index].root;
+    return index - virtual_vertices_;
+  }
+  // Return RootRank of a given vertex.  Mainly for debugging.
+  RootRank get_root_rank(Vertex vertex) const {
+    RootRank rr = roots_[to_index(vertex)];
+    return RootRank{ rr.root - virtual_vertices_, rr.rank, rr.size };
+  }
+  // Join a pair of vertices.  Return true if they were in different
+  // sets.
+  bool join(Vertex vertex1, Vertex vertex2);
+  // Undo all unions since the given mark of checkpoint().
+  void rollback(int checkpoint);
+
+ private:
+  // Undo log entry of a union: the root linked under another root, and
+  // whether the rank of the other root grew.
+  struct Union {
+    Vertex child;
+    bool rank_grew;
+  };
+  // Return index of the given vertex in the roots.
+  Vertex to_index(Vertex vertex) const {
+    assert(-virtual_vertices_ <= vertex &&
+	   vertex < Vertex(roots_.size()) - virtual_vertices_);
+    return vertex + virtual_vertices_;
+  }
+  // Undo log of the unions.
+  vector<Union> log_;
+  // RootRank of each index, with parents as indices.
+  vector<RootRank> roots_;
+  // Number of virtual vertices, which come first in the roots.
+  Vertex virtual_vertices_;
 };
 
 #endif // UNION_FIND_H_
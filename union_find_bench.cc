@@ -0,0 +1,424 @@
+// Benchmark of union-find data structures: the vector-backed UnionFind
+// against the former hash-map implementation on random joins and finds,
+// and the find policies of UnionFind on the access patterns of hex games
+// and of Kruskal's MST algorithm, and scalar against batched finds and
+// joins on a universe far beyond the cache.
+
+#include "benchmark.h"
+#include "union_find.h"
+
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace po = boost::program_options;
+
+using namespace std;
+
+// Virtual border vertices of a hex board, as in HexBoard.
+const Vertex NORTH_VERTEX = -1;
+const Vertex SOUTH_VERTEX = -2;
+const Vertex WEST_VERTEX = -3;
+const Vertex EAST_VERTEX = -4;
+
+// Command line options.
+struct Options {
+  // Hex board size.
+  int board;
+  // Benchmark report format.
+  ReportFormat format;
+  // Number of hex games per repetition.
+  int games;
+  // Side of the grid graph of Kruskal's algorithm.
+  int grid;
+  // Number of vertices of the batched benchmark.
+  int large;
+  // Number of finds and of joins per repetition.
+  int operations;
+  // Benchmark repetitions.
+  int repetitions;
+  // Seed of the random vertex pairs.
+  unsigned seed;
+  // Number of vertices.
+  int vertices;
+};
+
+// Types of union-find operations in a workload.
+// - CLEAR: clear the union-finds of both players.
+// - CONNECTED: check whether two vertices are connected.
+// - JOIN: join two vertices.
+// - KRUSKAL: join two vertices if they are not connected yet.
+enum class OpType { CLEAR, CONNECTED, JOIN, KRUSKAL };
+
+// Union-find operation on the union-find of a player.
+struct UnionFindOp {
+  OpType type;
+  int player;
+  Vertex vertex1, vertex2;
+};
+
+// Union-find keyed by a hash map, as UnionFind was before it moved to
+// dense vectors.  Kept as the baseline of the benchmark.
+class HashUnionFind {
+ public:
+  // Return the root vertex of a given vertex.
+  Vertex find(Vertex vertex) {
+    if(!vertex_map_.count(vertex)) {
+      RootRank rr = { vertex, 0, 1 };
+      vertex_map_.emplace(vertex, rr);
+      return vertex;
+    }
+    Vertex root = vertex_map_[vertex].root;
+    if(vertex_map_[root].root == root)
+      return root;
+    return path_compression(vertex);
+  }
+  // Join a pair of vertices.
+  void join(Vertex vertex1, Vertex vertex2) {
+    Vertex root1 = find(vertex1);
+    Vertex root2 = find(vertex2);
+    if(root1 == root2)
+      return;
+    if(vertex_map_[root2].rank > vertex_map_[root1].rank)
+      swap(root1, root2);
+    vertex_map_[root2].root = root1;
+    vertex_map_[root1].rank++;
+  }
+
+ private:
+  // Perform path compression starting from the given vertex.
+  Vertex path_compression(Vertex vertex) {
+    Vertex root = vertex_map_[vertex].root;
+    vector<Vertex> updates = { vertex };
+    while(vertex_map_[root].root != root) {
+      updates.push_back(root);
+      root = vertex_map_[root].root;
+    }
+    for(auto& v: updates)
+      vertex_map_[v].root = root;
+    return root;
+  }
+  // Vertex-to-RootRank mapping.
+  unordered_map<Vertex, RootRank> vertex_map_;
+};
+
+// Parse command line arguments and return the options.
+Options parse_cmd_line(int argc, char* argv[]) {
+  Options options;
+  string format;
+
+  // Parse and handle command line options.
+  po::options_description desc("Allowed options");
+  desc.add_options()
+    ("help,h", "Produce help message.")
+    ("board,b", po::value<int>(&options.board)->default_value(11),
+     "Hex board size.")
+    ("format", po::value<string>(&format)->default_value("json"),
+     "Benchmark report format: json or csv.")
+    ("games,g", po::value<int>(&options.games)->default_value(20000),
+     "Hex games per repetition.")
+    ("grid", po::value<int>(&options.grid)->default_value(1000),
+     "Side of the grid graph of Kruskal's algorithm.")
+    ("large,l", po::value<int>(&options.large)->default_value(1 << 24),
+     "Vertices of the scalar against batched benchmark.  The default "
+     "takes 256 MB, beyond the last-level cache.")
+    ("operations,o",
+     po::value<int>(&options.operations)->default_value(1000000),
+     "Number of joins, and of finds, per repetition.")
+    ("repetitions,r",
+     po::value<int>(&options.repetitions)->default_value(10),
+     "Benchmark repetitions.")
+    ("seed,s", po::value<unsigned>(&options.seed)->default_value(1),
+     "Seed of the random vertex pairs.")
+    ("vertices,v", po::value<int>(&options.vertices)->default_value(1000000),
+     "Number of vertices.");
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  // --help option.
+  if(vm.count("help")) {
+    cout << desc << endl;
+    exit(1);
+  }
+
+  // --format option.
+  if(!parse_report_format(format, options.format)) {
+    cout << "Unknown report format: " << format << endl;
+    exit(1);
+  }
+  if(options.repetitions < 1)
+    options.repetitions = 1;
+  return options;
+}
+
+// Time joins of the given pairs, then finds of the given vertices, on a
+// new union-find.  Add the elapsed times to the phase statistics and
+// return the sum of the roots found.
+template <typename UF>
+long run_union_find(UF uf, const vector<Vertex>& pairs,
+		    const vector<Vertex>& queries, TimingStats& join_stats,
+		    TimingStats& find_stats) {
+  Stopwatch stopwatch = Stopwatch();
+  long checksum = 0;
+
+  for(int i = 0; i < int(pairs.size()); i += 2)
+    uf.join(pairs[i], pairs[i + 1]);
+  join_stats.add(stopwatch.lap());
+  for(Vertex vertex: queries)
+    checksum += uf.find(vertex);
+  find_stats.add(stopwatch.elapsed());
+  return checksum;
+}
+
+// Return the operations of random hex games on a board of the given
+// size, as HexBoard::update_player_move() and the winner check issue
+// them.  Each move joins the new stone with the neighboring stones and
+// border of its player, and then checks whether the borders of the
+// player are connected.  A game ends at its winning move.
+vector<UnionFindOp> hex_workload(int board, int games, mt19937& generator) {
+  vector<UnionFindOp> ops;
+  vector<int> cells(board * board), owner(board * board);
+  UnionFind uf[2] = { UnionFind(board * board), UnionFind(board * board) };
+  // Neighbor deltas, as in Position::neighbors().
+  const int drow[] = { -1, 1, 0, 0, -1, 1 };
+  const int dcolumn[] = { 0, 0, 1, -1, 1, -1 };
+
+  for(int game = 0; game < games; game++) {
+    ops.push_back(UnionFindOp{ OpType::CLEAR, 0, 0, 0 });
+    uf[0].clear();
+    uf[1].clear();
+    for(int cell = 0; cell < int(cells.size()); cell++) {
+      cells[cell] = cell;
+      owner[cell] = -1;
+    }
+    shuffle(cells.begin(), cells.end(), generator);
+    for(int move = 0; move < int(cells.size()); move++) {
+      int player = move % 2, cell = cells[move];
+      int row = cell / board, column = cell % board;
+      owner[cell] = player;
+      for(int i = 0; i < 6; i++) {
+	int r = row + drow[i], c = column + dcolumn[i];
+	if(r < 0 || r >= board || c < 0 || c >= board ||
+	   owner[r * board + c] != player)
+	  continue;
+	ops.push_back(UnionFindOp{ OpType::JOIN, player, r * board + c, cell });
+	uf[player].join(r * board + c, cell);
+      }
+      Vertex border = -5, start, end;
+      if(player == 0) {
+	start = NORTH_VERTEX;
+	end = SOUTH_VERTEX;
+	if(row == 0)
+	  border = NORTH_VERTEX;
+	else if(row == board - 1)
+	  border = SOUTH_VERTEX;
+      } else {
+	start = WEST_VERTEX;
+	end = EAST_VERTEX;
+	if(column == 0)
+	  border = WEST_VERTEX;
+	else if(column == board - 1)
+	  border = EAST_VERTEX;
+      }
+      if(border != -5) {
+	ops.push_back(UnionFindOp{ OpType::JOIN, player, border, cell });
+	uf[player].join(border, cell);
+      }
+      ops.push_back(UnionFindOp{ OpType::CONNECTED, player, start, end });
+      if(uf[player].find(start) == uf[player].find(end))
+	break;
+    }
+  }
+  return ops;
+}
+
+// Return the operations of Kruskal's algorithm on a grid graph of the
+// given side with random edge weights: the edges in order of weight,
+// each joined if its endpoints are not connected yet.
+vector<UnionFindOp> kruskal_workload(int grid, mt19937& generator) {
+  vector<UnionFindOp> ops;
+
+  for(Vertex vertex = 0; vertex < grid * grid; vertex++) {
+    if(vertex % grid + 1 < grid)
+      ops.push_back(UnionFindOp{ OpType::KRUSKAL, 0, vertex, vertex + 1 });
+    if(vertex + grid < grid * grid)
+      ops.push_back(UnionFindOp{ OpType::KRUSKAL, 0, vertex, vertex + grid });
+  }
+  shuffle(ops.begin(), ops.end(), generator);
+  return ops;
+}
+
+// Time the operations on two new union-finds of the given universe and
+// find policy.  Add the elapsed time to the timing statistics and
+// return the number of connected checks and Kruskal joins that found
+// connected vertices.
+long run_workload(const vector<UnionFindOp>& ops, Vertex universe,
+		  FindPolicy policy, TimingStats& stats) {
+  UnionFind uf[2] = { UnionFind(universe, policy),
+		      UnionFind(universe, policy) };
+  Stopwatch stopwatch = Stopwatch();
+  long checksum = 0;
+
+  for(auto& op: ops) {
+    UnionFind& player_uf = uf[op.player];
+    switch(op.type) {
+    case OpType::CLEAR:
+      uf[0].clear();
+      uf[1].clear();
+      break;
+    case OpType::CONNECTED:
+      checksum += player_uf.find(op.vertex1) == player_uf.find(op.vertex2);
+      break;
+    case OpType::JOIN:
+      player_uf.join(op.vertex1, op.vertex2);
+      break;
+    case OpType::KRUSKAL:
+      if(player_uf.find(op.vertex1) == player_uf.find(op.vertex2))
+	checksum++;
+      else
+	player_uf.join(op.vertex1, op.vertex2);
+      break;
+    }
+  }
+  stats.add(stopwatch.elapsed());
+  return checksum;
+}
+
+// Time scalar and batched finds of the queries, then scalar and batched
+// joins of the pairs, each on a fresh copy of the given union-find.  Add
+// the elapsed times to the phase statistics, and return the sum of the
+// roots found plus the number of links, for both modes.
+pair<long, long> run_batched(const UnionFind& base,
+			     const vector<Vertex>& queries,
+			     const vector<pair<Vertex, Vertex> >& pairs,
+			     vector<TimingStats>& stats) {
+  const int batch = 1024;
+  vector<Vertex> roots(queries.size());
+  long scalar = 0, batched = 0;
+
+  UnionFind uf = base;
+  Stopwatch stopwatch = Stopwatch();
+  for(Vertex vertex: queries)
+    scalar += uf.find(vertex);
+  stats[0].add(stopwatch.elapsed());
+  uf = base;
+  stopwatch.restart();
+  uf.find_many(queries.data(), queries.size(), roots.data());
+  stats[1].add(stopwatch.elapsed());
+  for(Vertex root: roots)
+    batched += root;
+
+  uf = base;
+  stopwatch.restart();
+  for(auto& pair: pairs) {
+    Vertex root1 = uf.find(pair.first), root2 = uf.find(pair.second);
+    if(root1 != root2) {
+      uf.join(root1, root2);
+      scalar++;
+    }
+  }
+  stats[2].add(stopwatch.elapsed());
+  uf = base;
+  stopwatch.restart();
+  for(int first = 0; first < int(pairs.size()); first += batch)
+    batched += uf.join_many(&pairs[first],
+			    min<int>(batch, pairs.size() - first));
+  stats[3].add(stopwatch.elapsed());
+  return make_pair(scalar, batched);
+}
+
+// Main routine.
+int main(int argc, char* argv[]) {
+  Options options = parse_cmd_line(argc, argv);
+  TimingStats hash_join, hash_find, vector_join, vector_find;
+  vector<Vertex> pairs(2 * options.operations), queries(options.operations);
+  mt19937 generator(options.seed);
+  uniform_int_distribution<Vertex> distribution(0, options.vertices - 1);
+  long hash_checksum = 0, vector_checksum = 0;
+  const FindPolicy policies[] = { FindPolicy::FULL_COMPRESSION,
+				  FindPolicy::PATH_HALVING,
+				  FindPolicy::PATH_SPLITTING };
+  const string policy_names[] = { "full", "halving", "splitting" };
+  vector<TimingStats> hex_stats(3), kruskal_stats(3), batched_stats(4);
+  const string batched_names[] = { "scalar_find", "batch_find",
+				   "scalar_join", "batch_join" };
+  pair<long, long> batched_checksums;
+  long hex_checksum[3], kruskal_checksum[3];
+
+  for(auto& vertex: pairs)
+    vertex = distribution(generator);
+  for(auto& vertex: queries)
+    vertex = distribution(generator);
+  vector<UnionFindOp> hex_ops = hex_workload(options.board, options.games,
+					     generator);
+  vector<UnionFindOp> kruskal_ops = kruskal_workload(options.grid,
+						     generator);
+
+  // The large union-find starts with half as many random joins as
+  // vertices, which leaves paths of several entries.
+  UnionFind large = UnionFind(options.large);
+  uniform_int_distribution<Vertex> large_distribution(0, options.large - 1);
+  vector<Vertex> large_queries(options.operations);
+  vector<pair<Vertex, Vertex> > large_pairs(options.operations);
+  for(int i = 0; i < options.large / 2; i++)
+    large.join(large_distribution(generator), large_distribution(generator));
+  for(auto& vertex: large_queries)
+    vertex = large_distribution(generator);
+  for(auto& pair: large_pairs)
+    pair = make_pair(large_distribution(generator),
+		     large_distribution(generator));
+  for(int i = 0; i < options.repetitions; i++) {
+    batched_checksums = run_batched(large, large_queries, large_pairs,
+				    batched_stats);
+    hash_checksum = run_union_find(HashUnionFind(), pairs, queries,
+				   hash_join, hash_find);
+    vector_checksum = run_union_find(UnionFind(options.vertices), pairs,
+				     queries, vector_join, vector_find);
+    for(int p = 0; p < 3; p++) {
+      hex_checksum[p] = run_workload(hex_ops, options.board * options.board,
+				     policies[p], hex_stats[p]);
+      kruskal_checksum[p] = run_workload(kruskal_ops,
+					 options.grid * options.grid,
+					 policies[p], kruskal_stats[p]);
+    }
+  }
+
+  // All policies and modes must agree on connectivity.
+  assert(batched_checksums.first == batched_checksums.second);
+  for(int p = 1; p < 3; p++)
+    assert(hex_checksum[p] == hex_checksum[0] &&
+	   kruskal_checksum[p] == kruskal_checksum[0]);
+
+  // Checksums may differ, as the baseline grows ranks on every join.
+  BenchmarkReport report = BenchmarkReport("union_find");
+  report.add_parameter("vertices", options.vertices);
+  report.add_parameter("operations", options.operations);
+  report.add_parameter("repetitions", options.repetitions);
+  report.add_parameter("board", options.board);
+  report.add_parameter("games", options.games);
+  report.add_parameter("grid", options.grid);
+  report.add_parameter("large", options.large);
+  report.add_parameter("hex_ops", hex_ops.size());
+  report.add_parameter("kruskal_ops", kruskal_ops.size());
+  report.add_parameter("hash_checksum", hash_checksum);
+  report.add_parameter("vector_checksum", vector_checksum);
+  report.add_parameter("peak_rss_kb", peak_rss_kb());
+  report.add_phase("hash_join", hash_join);
+  report.add_phase("hash_find", hash_find);
+  report.add_phase("vector_join", vector_join);
+  report.add_phase("vector_find", vector_find);
+  for(int p = 0; p < 3; p++)
+    report.add_phase("hex_" + policy_names[p], hex_stats[p]);
+  for(int p = 0; p < 3; p++)
+    report.add_phase("kruskal_" + policy_names[p], kruskal_stats[p]);
+  for(int p = 0; p < 4; p++)
+    report.add_phase(batched_names[p], batched_stats[p]);
+  report.write(cout, options.format);
+  return 0;
+}
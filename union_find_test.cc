@@ -4,6 +4,8 @@
 #include "union_find.h"
 #include "gtest/gtest.h"
 
+#include <vector>
+
 using namespace std;
 
 
@@ -72,3 +74,245 @@ TEST(union_find_test_suite, test_copy_union_find) {
   EXPECT_EQ(1, uf2.find(1)) << "vertex: 1 should have root: 1";
   EXPECT_EQ(1, uf2.find(2)) << "vertex: 2 should have root: 1";
 }
+
+TEST(union_find_test_suite, test_rank_grows_on_equal_ranks) {
+  UnionFind uf = UnionFind();
+  uf.join(0, 1);
+  uf.join(0, 2);
+  RootRank expect = { 0, 1 };
+  EXPECT_EQ(expect, uf.get_root_rank(0))
+    << "Joining a lower rank should keep rank: 1.";
+  uf.join(3, 4);
+  uf.join(3, 0);
+  expect = { 3, 2 };
+  EXPECT_EQ(expect, uf.get_root_rank(3))
+    << "Joining equal ranks should give rank: 2.";
+  expect = { 3, 1 };
+  EXPECT_EQ(expect, uf.get_root_rank(0))
+    << "Old root should keep its rank.";
+}
+
+TEST(union_find_test_suite, test_fixed_universe) {
+  UnionFind uf = UnionFind(10);
+  for(Vertex v = 0; v < 10; v++) {
+    RootRank expect = { v, 0 };
+    EXPECT_EQ(expect, uf.get_root_rank(v))
+      << "vertex: " << v << " should start as a singleton.";
+  }
+  uf.join(2, 7);
+  uf.join(7, 9);
+  EXPECT_EQ(uf.find(2), uf.find(9)) << "vertex: 2 and 9 should be joined.";
+  uf.clear();
+  EXPECT_EQ(9, uf.find(9)) << "Clear should reset vertex: 9.";
+  RootRank expect = { 2, 0 };
+  EXPECT_EQ(expect, uf.get_root_rank(2)) << "Clear should reset rank.";
+}
+
+TEST(union_find_test_suite, test_negative_vertices) {
+  // Virtual vertices of a hex board next to position vertices.
+  UnionFind uf = UnionFind(9);
+  uf.join(-1, 0);
+  uf.join(-2, 8);
+  EXPECT_NE(uf.find(-1), uf.find(-2)) << "Borders should not be joined.";
+  uf.join(0, 4);
+  uf.join(4, 8);
+  EXPECT_EQ(uf.find(-1), uf.find(-2)) << "Borders should be joined.";
+  EXPECT_EQ(-4, uf.find(-4)) << "vertex: -4 should be a singleton.";
+  uf.clear();
+  EXPECT_NE(uf.find(-1), uf.find(-2)) << "Clear should split borders.";
+}
+
+// Join vertices 0 to 7 into a binomial tree of rank 3 with the path
+// 7 -> 6 -> 4 -> 0.
+static void join_binomial_tree(UnionFind& uf) {
+  uf.join(0, 1);
+  uf.join(2, 3);
+  uf.join(0, 2);
+  uf.join(4, 5);
+  uf.join(6, 7);
+  uf.join(4, 6);
+  uf.join(0, 4);
+}
+
+TEST(union_find_test_suite, test_find_policies) {
+  UnionFind full = UnionFind(8, FindPolicy::FULL_COMPRESSION);
+  UnionFind halving = UnionFind(8, FindPolicy::PATH_HALVING);
+  UnionFind splitting = UnionFind(8, FindPolicy::PATH_SPLITTING);
+  join_binomial_tree(full);
+  join_binomial_tree(halving);
+  join_binomial_tree(splitting);
+  EXPECT_EQ(6, full.get_root_rank(7).root) << "Path should start at 6.";
+  EXPECT_EQ(0, full.find(7)) << "Full compression root is wrong.";
+  EXPECT_EQ(0, halving.find(7)) << "Path halving root is wrong.";
+  EXPECT_EQ(0, splitting.find(7)) << "Path splitting root is wrong.";
+
+  // Full compression points the path to the root, halving points every
+  // other vertex to its grandparent and splitting points every vertex to
+  // its grandparent.
+  EXPECT_EQ(0, full.get_root_rank(7).root) << "7 should point to root.";
+  EXPECT_EQ(0, full.get_root_rank(6).root) << "6 should point to root.";
+  EXPECT_EQ(4, halving.get_root_rank(7).root) << "7 should skip to 4.";
+  EXPECT_EQ(4, halving.get_root_rank(6).root) << "6 should be skipped.";
+  EXPECT_EQ(4, splitting.get_root_rank(7).root) << "7 should skip to 4.";
+  EXPECT_EQ(0, splitting.get_root_rank(6).root) << "6 should skip to 0.";
+}
+
+TEST(union_find_test_suite, test_find_policies_match_labels) {
+  const int vertices = 200;
+  vector<FindPolicy> policies = { FindPolicy::FULL_COMPRESSION,
+				  FindPolicy::PATH_HALVING,
+				  FindPolicy::PATH_SPLITTING };
+  for(FindPolicy policy: policies) {
+    UnionFind uf = UnionFind(policy);
+    vector<int> labels(vertices);
+    unsigned state = 12345;
+    for(int v = 0; v < vertices; v++)
+      labels[v] = v;
+    for(int i = 0; i < 300; i++) {
+      state = state * 1103515245 + 12345;
+      int vertex1 = (state >> 8) % vertices;
+      state = state * 1103515245 + 12345;
+      int vertex2 = (state >> 8) % vertices;
+      uf.join(vertex1, vertex2);
+
+      // Relabel the component of vertex2 as that of vertex1.
+      int from = labels[vertex2], to = labels[vertex1];
+      for(auto& label: labels)
+	if(label == from)
+	  label = to;
+      for(int v = 0; v < vertices; v += 7)
+	ASSERT_EQ(labels[v] == labels[vertex1], uf.find(v) == uf.find(vertex1))
+	  << "Components are wrong after join: " << i;
+    }
+  }
+}
+
+TEST(rollback_union_find_test_suite, test_join_and_rollback) {
+  RollbackUnionFind uf = RollbackUnionFind(8, 2);
+  EXPECT_TRUE(uf.join(0, 1)) << "Join of new sets should link.";
+  int mark = uf.checkpoint();
+  EXPECT_TRUE(uf.join(2, 3));
+  EXPECT_TRUE(uf.join(0, 2));
+  EXPECT_TRUE(uf.join(-1, 3));
+  EXPECT_FALSE(uf.join(1, -1)) << "Join of one set should not link.";
+  EXPECT_EQ(uf.find(-1), uf.find(1)) << "-1 and 1 should be joined.";
+  RootRank expect = { 0, 2 };
+  EXPECT_EQ(expect, uf.get_root_rank(0)) << "0 should have rank: 2.";
+  uf.rollback(mark);
+  EXPECT_EQ(mark, uf.checkpoint()) << "Log should be back at the mark.";
+  EXPECT_EQ(uf.find(0), uf.find(1)) << "Union before mark should stay.";
+  EXPECT_NE(uf.find(0), uf.find(2)) << "Union after mark should go.";
+  EXPECT_EQ(-1, uf.find(-1)) << "-1 should be a singleton again.";
+  expect = { 0, 1 };
+  EXPECT_EQ(expect, uf.get_root_rank(0)) << "Rank should be restored.";
+  expect = { 2, 0 };
+  EXPECT_EQ(expect, uf.get_root_rank(2)) << "Rank should be restored.";
+}
+
+TEST(rollback_union_find_test_suite, test_nested_rollback) {
+  // Undoing random unions in nested checkpoints restores the
+  // components of each level.
+  const int vertices = 100;
+  RollbackUnionFind uf = RollbackUnionFind(vertices);
+  vector<int> marks;
+  vector<vector<Vertex> > roots;
+  unsigned state = 99;
+  for(int level = 0; level < 10; level++) {
+    marks.push_back(uf.checkpoint());
+    roots.push_back(vector<Vertex>());
+    for(Vertex v = 0; v < vertices; v++)
+      roots.back().push_back(uf.find(v));
+    for(int i = 0; i < 8; i++) {
+      state = state * 1103515245 + 12345;
+      Vertex vertex1 = (state >> 8) % vertices;
+      state = state * 1103515245 + 12345;
+      uf.join(vertex1, (state >> 8) % vertices);
+    }
+  }
+  for(int level = 9; level >= 0; level--) {
+    uf.rollback(marks[level]);
+    for(Vertex v = 0; v < vertices; v++)
+      ASSERT_EQ(roots[level][v], uf.find(v))
+	<< "Root is wrong at level: " << level << "; vertex: " << v;
+  }
+}
+
+TEST(union_find_test_suite, test_find_many) {
+  UnionFind uf = UnionFind(), expect = UnionFind();
+  unsigned state = 7;
+  for(int i = 0; i < 500; i++) {
+    state = state * 1103515245 + 12345;
+    Vertex vertex1 = (state >> 8) % 1000;
+    state = state * 1103515245 + 12345;
+    Vertex vertex2 = (state >> 8) % 1000;
+    uf.join(vertex1, vertex2);
+    expect.join(vertex1, vertex2);
+  }
+  uf.join(-2, 5);
+  expect.join(-2, 5);
+
+  // Include repeated, negative and new vertices.
+  vector<Vertex> vertices = { 5, -2, -3, 1200, 5 };
+  for(Vertex v = 0; v < 1000; v += 3)
+    vertices.push_back(v);
+  vector<Vertex> roots(vertices.size());
+  uf.find_many(vertices.data(), vertices.size(), roots.data());
+  for(size_t i = 0; i < vertices.size(); i++) {
+    ASSERT_EQ(expect.find(vertices[i]), roots[i])
+      << "Root is wrong for vertex: " << vertices[i];
+    ASSERT_EQ(roots[i], uf.get_root_rank(vertices[i]).root)
+      << "Path should be compressed for vertex: " << vertices[i];
+  }
+
+  // Roots may be written over the vertices.
+  uf.find_many(vertices.data(), vertices.size(), vertices.data());
+  EXPECT_TRUE(roots == vertices) << "In-place roots should match.";
+}
+
+TEST(union_find_test_suite, test_join_many) {
+  vector<pair<Vertex, Vertex> > pairs = { { 0, 1 }, { 2, 3 }, { 1, 0 },
+					  { 3, 0 }, { 2, 1 }, { 4, -1 },
+					  { 5, 5 }, { -1, 3 } };
+  UnionFind uf = UnionFind(), expect = UnionFind();
+  bool linked[8];
+  bool expect_linked[] = { true, true, false, true, false, true, false,
+			   true };
+  EXPECT_EQ(5, uf.join_many(pairs.data(), pairs.size(), linked))
+    << "Five pairs should link.";
+  for(size_t i = 0; i < pairs.size(); i++) {
+    EXPECT_EQ(expect_linked[i], linked[i]) << "Link flag is wrong: " << i;
+    expect.join(pairs[i].first, pairs[i].second);
+  }
+  for(Vertex v = -1; v <= 5; v++)
+    EXPECT_EQ(expect.find(v), uf.find(v)) << "Root is wrong: " << v;
+}
+
+TEST(union_find_test_suite, test_component_count_and_size) {
+  UnionFind uf = UnionFind(10);
+  vector<pair<Vertex, Vertex> > merges;
+  uf.set_merge_hook([&](Vertex size1, Vertex size2) {
+      merges.push_back(make_pair(size1, size2));
+    });
+  EXPECT_EQ(10, uf.component_count()) << "All vertices should be apart.";
+  uf.join(0, 1);
+  uf.join(2, 3);
+  uf.join(3, 4);
+  uf.join(0, 4);
+  uf.join(1, 2);
+  EXPECT_EQ(6, uf.component_count()) << "Four joins should merge.";
+  EXPECT_EQ(5, uf.component_size(3)) << "Component of 3 is wrong.";
+  EXPECT_EQ(1, uf.component_size(9)) << "Component of 9 is wrong.";
+  ASSERT_EQ(4, merges.size()) << "Hook should see every merge.";
+  EXPECT_EQ(make_pair(1L, 1L), merges[0]) << "First merge is wrong.";
+  EXPECT_EQ(make_pair(2L, 1L), merges[2]) << "Third merge is wrong.";
+  EXPECT_EQ(5, merges[3].first + merges[3].second)
+    << "Last merge should give 5.";
+
+  // A negative vertex adds a component, and clear resets the counts.
+  uf.join(-1, 9);
+  EXPECT_EQ(6, uf.component_count()) << "-1 should join 9.";
+  EXPECT_EQ(2, uf.component_size(-1)) << "Component of -1 is wrong.";
+  uf.clear();
+  EXPECT_EQ(10, uf.component_count()) << "Clear should reset the count.";
+  EXPECT_EQ(1, uf.component_size(3)) << "Clear should reset the size.";
+}